@@ -12,6 +12,8 @@
 
 namespace pvxs {
 
+using detail::ctz64;
+using detail::popcount64;
 
 BitMask::BitMask(BitMask&& o) noexcept
     :_words(std::move(o._words))
@@ -48,43 +50,36 @@ void BitMask::resize(size_t bits) {
     _size = uint16_t(bits);
 }
 
-size_t BitMask::findSet(size_t start) const
+size_t BitMask::findSet(size_t start, size_t end) const
 {
-    while(start < _size) {
-        size_t word = start/64u,
-                bit = start%64u;
-
-        // first see if we can skip to next word
-        uint64_t mask = ~((1ull<<bit)-1); // mask of bit and higher
-        uint64_t masked = _words[word]&mask;
-        if(masked==0u) {
-            start = (word+1u)*64u;
-            continue;
-        }
-
-        // the answer is in range [bit, 64)
-
-        // count consecutive "trailing" zeros.
-        // http://graphics.stanford.edu/~seander/bithacks.html#ZerosOnRightParallel
-
-        masked &= -masked; // and with two's complement.  neat.  clears all except the bit we care about
-
-        // now a binary search
-        // we know masked is non-zero, and can start from 63
-        //bit = 64u;
-        //if(masked) bit--;
-        bit = 63u;
-        if(masked&0x00000000ffffffffull) bit -= 32u;
-        if(masked&0x0000ffff0000ffffull) bit -= 16u;
-        if(masked&0x00ff00ff00ff00ffull) bit -= 8u;
-        if(masked&0x0f0f0f0f0f0f0f0full) bit -= 4u;
-        if(masked&0x3333333333333333ull) bit -= 2u; // 0xb0011 repeated
-        if(masked&0x5555555555555555ull) bit -= 1u; // 0xb0101 repeated
-
-        return (word*64u) | bit;
+    if(end > _size)
+        end = _size;
+    if(start >= end)
+        return end;
+
+    size_t word = start/64u;
+    // mask of start bit and higher
+    uint64_t masked = _words[word] & (~uint64_t(0u) << (start%64u));
+
+    // skip over whole words of zeros
+    for(const size_t lastword = (end-1u)/64u; !masked; ) {
+        if(++word > lastword)
+            return end;
+        masked = _words[word];
     }
 
-    return _size;
+    size_t bit = word*64u + ctz64(masked);
+    return bit < end ? bit : end;
+}
+
+size_t BitMask::count() const
+{
+    size_t ret = 0u;
+    for(auto w : _words)
+        ret += popcount64(w);
+    if(auto extra = _size%64u) // ignore storage bits beyond size()
+        ret -= popcount64(_words.back() & (~uint64_t(0u) << extra));
+    return ret;
 }
 
 std::ostream& operator<<(std::ostream& strm, const BitMask& mask)
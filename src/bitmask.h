@@ -14,9 +14,52 @@
 
 #include <pvxs/version.h>
 
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#  include <intrin.h>
+#endif
+
 namespace pvxs {
 
 namespace detail {
+//! index of lowest set bit.
+//! @pre v!=0
+inline
+unsigned ctz64(uint64_t v)
+{
+#if defined(__GNUC__)
+    return unsigned(__builtin_ctzll(v));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long ret;
+    _BitScanForward64(&ret, v);
+    return unsigned(ret);
+#else
+    // http://graphics.stanford.edu/~seander/bithacks.html#ZerosOnRightParallel
+    v &= -v; // clear all except lowest set bit
+    unsigned bit = 63u;
+    if(v&0x00000000ffffffffull) bit -= 32u;
+    if(v&0x0000ffff0000ffffull) bit -= 16u;
+    if(v&0x00ff00ff00ff00ffull) bit -= 8u;
+    if(v&0x0f0f0f0f0f0f0f0full) bit -= 4u;
+    if(v&0x3333333333333333ull) bit -= 2u; // 0xb0011 repeated
+    if(v&0x5555555555555555ull) bit -= 1u; // 0xb0101 repeated
+    return bit;
+#endif
+}
+
+//! number of set bits
+inline
+unsigned popcount64(uint64_t v)
+{
+#if defined(__GNUC__)
+    return unsigned(__builtin_popcountll(v));
+#else
+    v = v - ((v>>1u) & 0x5555555555555555ull);
+    v = (v & 0x3333333333333333ull) + ((v>>2u) & 0x3333333333333333ull);
+    v = (v + (v>>4u)) & 0x0f0f0f0f0f0f0f0full;
+    return unsigned((v * 0x0101010101010101ull) >> 56u);
+#endif
+}
+
 // base type, defines operations which can be performed on an BitMask expression
 template <typename Sub>
 struct BitBase {
@@ -134,8 +177,15 @@ public:
 
     //! Returns index of first set bit in range [start, size()] inclusive.
     //! Returns size() if no bits are set.
+    size_t findSet(size_t start=0u) const { return findSet(start, _size); }
+    //! Returns index of first set bit in range [start, end) .
+    //! Returns end if no bits are set.
+    PVXS_API
+    size_t findSet(size_t start, size_t end) const;
+
+    //! Number of set bits
     PVXS_API
-    size_t findSet(size_t start=0u) const;
+    size_t count() const;
 
 private:
     template<typename BR>
@@ -170,14 +220,31 @@ private:
     class _SetIter {
         friend BitMask;
         const BitMask* _mask = nullptr;
-        size_t _bit = 0u;
+        size_t _bit = 0u, _end = 0u;
+        // bits of the current word above _bit which remain to be visited
+        uint64_t _rest = 0u;
+
+        void advance() {
+            if(_rest) {
+                // next bit is in the same word
+                _bit = (_bit & ~size_t(63u)) | detail::ctz64(_rest);
+                if(_bit >= _end)
+                    _bit = _end;
+            } else {
+                _bit = _mask->findSet((_bit|63u)+1u, _end);
+            }
+            load();
+        }
+        void load() {
+            _rest = _bit<_end ? _mask->_words[_bit/64u] & (~uint64_t(1u) << (_bit%64u)) : 0u;
+        }
     public:
         constexpr _SetIter() = default;
-        constexpr _SetIter(const BitMask* mask, size_t bit) :_mask(mask), _bit(bit) {}
+        _SetIter(const BitMask* mask, size_t bit, size_t end) :_mask(mask), _bit(bit), _end(end) { load(); }
 
         size_t operator*() const { return _bit; }
-        _SetIter& operator++() { _bit=_mask->findSet(_bit+1); return *this; }
-        _SetIter operator++(int) { _SetIter ret{*this}; _bit=_mask->findSet(_bit+1); return ret;}
+        _SetIter& operator++() { advance(); return *this; }
+        _SetIter operator++(int) { _SetIter ret{*this}; advance(); return ret;}
 
         bool operator==(const _SetIter& o) { return _bit==o._bit; }
         bool operator!=(const _SetIter& o) { return _bit!=o._bit; }
@@ -189,8 +256,8 @@ private:
         constexpr explicit _OnlySet(const BitMask* mask, size_t a, size_t b) :_mask(mask), a(a), b(b) {}
     public:
         typedef _SetIter iterator;
-        iterator begin() const { return iterator{_mask, _mask->findSet(a)}; }
-        iterator end() const { return iterator{_mask, b}; }
+        iterator begin() const { return iterator{_mask, _mask->findSet(a, b), b}; }
+        iterator end() const { return iterator{_mask, b, b}; }
     };
 
 public:
@@ -0,0 +1,245 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <cstring>
+#include <stdexcept>
+
+#include "pvaproto.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#  define SWAP_SSE2
+#  include <emmintrin.h>
+   // target attribute with AVX2 intrinsics w/o -mavx2 needs GCC >= 4.9, or clang
+#  if defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9)
+#    define SWAP_AVX2
+#    include <immintrin.h>
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define SWAP_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace pvxs {namespace impl {
+
+namespace {
+
+typedef void (*swap_fn)(uint8_t* dest, const uint8_t* src, size_t count);
+
+struct Kernel {
+    SwapKernel id;
+    swap_fn w2, w4, w8;
+};
+
+inline uint16_t bswap(uint16_t v) { return uint16_t((v<<8u) | (v>>8u)); }
+inline uint32_t bswap(uint32_t v) {
+    return (v<<24u) | ((v<<8u)&0x00ff0000u) | ((v>>8u)&0x0000ff00u) | (v>>24u);
+}
+inline uint64_t bswap(uint64_t v) {
+    return (uint64_t(bswap(uint32_t(v)))<<32u) | bswap(uint32_t(v>>32u));
+}
+
+// memcpy() to allow unaligned src and dest
+template<typename T>
+void swapScalar(uint8_t* dest, const uint8_t* src, size_t count)
+{
+    for(size_t i=0u; i<count; i++) {
+        T v;
+        memcpy(&v, src + i*sizeof(T), sizeof(T));
+        v = bswap(v);
+        memcpy(dest + i*sizeof(T), &v, sizeof(T));
+    }
+}
+
+const Kernel kernScalar{SwapKernel::Scalar,
+                        &swapScalar<uint16_t>,
+                        &swapScalar<uint32_t>,
+                        &swapScalar<uint64_t>};
+
+#ifdef SWAP_SSE2
+// SSE2 has no byte shuffle, so swap 16-bit words, then bytes within each word
+template<size_t W>
+__m128i sse2Swap(__m128i v);
+
+template<>
+inline __m128i sse2Swap<2>(__m128i v)
+{
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+template<>
+inline __m128i sse2Swap<4>(__m128i v)
+{
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return sse2Swap<2>(v);
+}
+
+template<>
+inline __m128i sse2Swap<8>(__m128i v)
+{
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    return sse2Swap<2>(v);
+}
+
+template<typename T>
+void swapSSE2(uint8_t* dest, const uint8_t* src, size_t count)
+{
+    const size_t nbytes = count*sizeof(T);
+    size_t n = 0u;
+    for(; n+16u <= nbytes; n+=16u) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + n));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + n), sse2Swap<sizeof(T)>(v));
+    }
+    swapScalar<T>(dest + n, src + n, (nbytes - n)/sizeof(T));
+}
+
+const Kernel kernSSE2{SwapKernel::SSE2,
+                      &swapSSE2<uint16_t>,
+                      &swapSSE2<uint32_t>,
+                      &swapSSE2<uint64_t>};
+#endif // SWAP_SSE2
+
+#ifdef SWAP_AVX2
+template<typename T>
+__attribute__((target("avx2")))
+void swapAVX2(uint8_t* dest, const uint8_t* src, size_t count)
+{
+    const size_t nbytes = count*sizeof(T);
+    if(nbytes < 32u)
+        return swapScalar<T>(dest, src, count);
+
+    // _mm256_shuffle_epi8() permutes within each 128-bit lane
+    uint8_t order[32];
+    for(size_t i=0u; i<32u; i++)
+        order[i] = uint8_t((i%16u)/sizeof(T)*sizeof(T) + sizeof(T)-1u - i%sizeof(T));
+    const auto mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(order));
+
+    size_t n = 0u;
+    for(; n+32u <= nbytes; n+=32u) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + n));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + n), _mm256_shuffle_epi8(v, mask));
+    }
+    swapScalar<T>(dest + n, src + n, (nbytes - n)/sizeof(T));
+}
+
+const Kernel kernAVX2{SwapKernel::AVX2,
+                      &swapAVX2<uint16_t>,
+                      &swapAVX2<uint32_t>,
+                      &swapAVX2<uint64_t>};
+#endif // SWAP_AVX2
+
+#ifdef SWAP_NEON
+template<size_t W>
+uint8x16_t neonSwap(uint8x16_t v);
+template<> inline uint8x16_t neonSwap<2>(uint8x16_t v) { return vrev16q_u8(v); }
+template<> inline uint8x16_t neonSwap<4>(uint8x16_t v) { return vrev32q_u8(v); }
+template<> inline uint8x16_t neonSwap<8>(uint8x16_t v) { return vrev64q_u8(v); }
+
+template<typename T>
+void swapNEON(uint8_t* dest, const uint8_t* src, size_t count)
+{
+    const size_t nbytes = count*sizeof(T);
+    size_t n = 0u;
+    for(; n+16u <= nbytes; n+=16u) {
+        vst1q_u8(dest + n, neonSwap<sizeof(T)>(vld1q_u8(src + n)));
+    }
+    swapScalar<T>(dest + n, src + n, (nbytes - n)/sizeof(T));
+}
+
+const Kernel kernNEON{SwapKernel::NEON,
+                      &swapNEON<uint16_t>,
+                      &swapNEON<uint32_t>,
+                      &swapNEON<uint64_t>};
+#endif // SWAP_NEON
+
+// nullptr if not supported by this build or CPU
+const Kernel* lookup(SwapKernel id)
+{
+    switch(id) {
+    case SwapKernel::Scalar:
+        return &kernScalar;
+#ifdef SWAP_SSE2
+    case SwapKernel::SSE2:
+        return &kernSSE2;
+#endif
+#ifdef SWAP_AVX2
+    case SwapKernel::AVX2:
+        return __builtin_cpu_supports("avx2") ? &kernAVX2 : nullptr;
+#endif
+#ifdef SWAP_NEON
+    case SwapKernel::NEON:
+        return &kernNEON;
+#endif
+    default:
+        return nullptr;
+    }
+}
+
+const Kernel* pick()
+{
+    for(auto id : {SwapKernel::AVX2, SwapKernel::SSE2, SwapKernel::NEON}) {
+        if(auto kern = lookup(id))
+            return kern;
+    }
+    return &kernScalar;
+}
+
+const Kernel& selected()
+{
+    static const Kernel* kern = pick();
+    return *kern;
+}
+
+void doSwap(const Kernel& kern, void* dest, const void* src, size_t count, size_t width)
+{
+    auto d = static_cast<uint8_t*>(dest);
+    auto s = static_cast<const uint8_t*>(src);
+
+    switch(width) {
+    case 1u: memcpy(d, s, count); break;
+    case 2u: (*kern.w2)(d, s, count); break;
+    case 4u: (*kern.w4)(d, s, count); break;
+    case 8u: (*kern.w8)(d, s, count); break;
+    default:
+        throw std::logic_error(SB()<<"Unsupported byte swap width "<<width);
+    }
+}
+
+} // namespace
+
+const char* swapKernelName(SwapKernel id)
+{
+    switch(id) {
+#define CASE(NAME) case SwapKernel::NAME: return #NAME
+    CASE(Scalar);
+    CASE(SSE2);
+    CASE(AVX2);
+    CASE(NEON);
+#undef CASE
+    }
+    return "<invalid>";
+}
+
+SwapKernel swapKernelSelected()
+{
+    return selected().id;
+}
+
+void copySwapped(void* dest, const void* src, size_t count, size_t width)
+{
+    doSwap(selected(), dest, src, count, width);
+}
+
+bool copySwappedWith(SwapKernel id, void* dest, const void* src, size_t count, size_t width)
+{
+    auto kern = lookup(id);
+    if(kern)
+        doSwap(*kern, dest, src, count, width);
+    return !!kern;
+}
+
+}} // namespace pvxs::impl
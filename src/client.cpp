@@ -105,8 +105,10 @@ Timeout::Timeout()
 {}
 Timeout::~Timeout() {}
 
-Channel::Channel(const std::shared_ptr<ContextImpl>& context, const std::string& name, uint32_t cid)
+Channel::Channel(const std::shared_ptr<ContextImpl>& context, ClientWorker* worker,
+                 const std::string& name, uint32_t cid)
     :context(context)
+    ,worker(worker)
     ,name(name)
     ,cid(cid)
 {}
@@ -114,6 +116,9 @@ Channel::Channel(const std::shared_ptr<ContextImpl>& context, const std::string&
 Channel::~Channel()
 {
     disconnect(nullptr);
+    worker->chanByCID.erase(cid);
+    if(forcedServer.family()==AF_UNSPEC)
+        context->searchForget(cid);
 }
 
 void Channel::createOperations()
@@ -203,20 +208,18 @@ void Channel::disconnect(const std::shared_ptr<Channel>& self)
     }
 
     if(!self) { // in ~Channel
-        // searchBuckets cleaned in tickSearch()
+        // SearchEntry cleaned by searchForget()
 
     } else if(forcedServer.family()==AF_UNSPEC) { // begin search
 
-        auto next = (context->currentBucket + holdoff) % nBuckets;
-
-        context->searchBuckets[next].push_back(self);
+        context->searchStart(*this, holdoff, false);
 
         log_debug_printf(io, "Server %s detach channel '%s' to re-search\n",
                          current ? current->peerName.c_str() : "<disconnected>",
                          name.c_str());
 
     } else if(context->state==ContextImpl::Running) { // reconnect to specific server
-        conn = Connection::build(context, forcedServer, true);
+        conn = Connection::build(context, *worker, forcedServer, true);
 
         conn->pending[cid] = self;
         state = Connecting;
@@ -247,7 +250,7 @@ std::shared_ptr<Connect> ConnectBuilder::exec()
     auto syncCancel(_syncCancel);
     auto context(ctx->impl->shared_from_this());
 
-    auto op(std::make_shared<ConnectImpl>(context->tcp_loop, _pvname));
+    auto op(std::make_shared<ConnectImpl>(context->workerFor(_pvname).loop, _pvname));
     op->_onConn = std::move(_onConn);
     op->_onDis = std::move(_onDis);
 
@@ -267,7 +270,7 @@ std::shared_ptr<Connect> ConnectBuilder::exec()
     });
 
     auto server(std::move(_server));
-    context->tcp_loop.dispatch([op, context, server]() {
+    op->loop.dispatch([op, context, server]() {
         // on worker
 
         op->chan = Channel::build(context, op->_name, server);
@@ -349,8 +352,10 @@ std::shared_ptr<Channel> Channel::build(const std::shared_ptr<ContextImpl>& cont
     if(context->state!=ContextImpl::Running)
         throw std::logic_error("Context close()d");
 
+    auto& worker = context->workerFor(name);
+
     SockAddr forceServer;
-    decltype (context->chanByName)::key_type namekey(name, server);
+    decltype (worker.chanByName)::key_type namekey(name, server);
 
     if(!server.empty()) {
         forceServer.setAddress(server.c_str(), context->effective.tcp_port);
@@ -358,29 +363,29 @@ std::shared_ptr<Channel> Channel::build(const std::shared_ptr<ContextImpl>& cont
 
     std::shared_ptr<Channel> chan;
 
-    auto it = context->chanByName.find(namekey);
-    if(it!=context->chanByName.end()) {
+    auto it = worker.chanByName.find(namekey);
+    if(it!=worker.chanByName.end()) {
         chan = it->second;
         chan->garbage = false;
     }
 
     if(!chan) {
-        while(context->chanByCID.find(context->nextCID)!=context->chanByCID.end())
-            context->nextCID++;
+        uint32_t cid;
+        do {
+            cid = context->nextCID++;
+        } while(worker.chanByCID.find(cid)!=worker.chanByCID.end());
 
-        chan = std::make_shared<Channel>(context, name, context->nextCID);
+        chan = std::make_shared<Channel>(context, &worker, name, cid);
 
-        context->chanByCID[chan->cid] = chan;
-        context->chanByName[namekey] = chan;
+        worker.chanByCID[chan->cid] = chan;
+        worker.chanByName[namekey] = chan;
 
         if(server.empty()) {
-            context->initialSearchBucket.push_back(chan);
-
-            context->scheduleInitialSearch();
+            context->searchStart(*chan, 0u, true);
 
         } else { // bypass search and connect so a specific server
             chan->forcedServer = forceServer;
-            chan->conn = Connection::build(context, forceServer);
+            chan->conn = Connection::build(context, worker, forceServer);
 
             chan->conn->pending[chan->cid] = chan;
             chan->state = Connecting;
@@ -441,12 +446,15 @@ void Context::cacheClear(const std::string& name, cacheAction action)
     if(!pvt)
         throw std::logic_error("NULL Context");
 
-    pvt->impl->tcp_loop.call([this, name, action](){
-        // run twice to ensure both mark and sweep of all unused channels
-        log_debug_printf(setup, "cacheClear('%s')\n", name.c_str());
-        pvt->impl->cacheClean(name, action);
-        pvt->impl->cacheClean(name, action);
-    });
+    log_debug_printf(setup, "cacheClear('%s')\n", name.c_str());
+
+    for(auto& worker : pvt->impl->workers) {
+        worker->loop.call([this, &worker, name, action](){
+            // run twice to ensure both mark and sweep of all unused channels
+            pvt->impl->cacheClean(*worker, name, action);
+            pvt->impl->cacheClean(*worker, name, action);
+        });
+    }
 }
 
 void Context::ignoreServerGUIDs(const std::vector<ServerGUID>& guids)
@@ -463,43 +471,53 @@ Report Context::report(bool zero) const
 {
     Report ret;
 
-    pvt->impl->tcp_loop.call([this, &ret, zero](){
+    for(auto& worker : pvt->impl->workers) {
+        worker->loop.call([&worker, &ret, zero](){
 
-        for(auto& pair : pvt->impl->connByAddr) {
-            auto conn = pair.second.lock();
-            if(!conn)
-                continue;
+            ret.workers.emplace_back();
+            auto& sworker = ret.workers.back();
+            sworker.name = worker->name;
 
-            ret.connections.emplace_back();
-            auto& sconn = ret.connections.back();
-            sconn.peer = conn->peerName;
-            sconn.tx = conn->statTx;
-            sconn.rx = conn->statRx;
+            for(auto& pair : worker->connByAddr) {
+                auto conn = pair.second.lock();
+                if(!conn)
+                    continue;
 
-            if(zero) {
-                conn->statTx = conn->statRx = 0u;
-            }
+                ret.connections.emplace_back();
+                auto& sconn = ret.connections.back();
+                sconn.peer = conn->peerName;
+                sconn.tx = conn->statTx;
+                sconn.rx = conn->statRx;
 
-            // omit stats for transitory conn->creatingByCID
+                sworker.connections++;
+                sworker.tx += conn->statTx;
+                sworker.rx += conn->statRx;
 
-            for(auto& pair : conn->chanBySID) {
-                auto chan = pair.second.lock();
-                if(!chan)
-                    continue;
+                if(zero) {
+                    conn->statTx = conn->statRx = 0u;
+                }
 
-                sconn.channels.emplace_back();
-                auto& schan = sconn.channels.back();
-                schan.name = chan->name;
-                schan.tx = chan->statTx;
-                schan.rx = chan->statRx;
+                // omit stats for transitory conn->creatingByCID
 
-                if(zero) {
-                    chan->statTx = chan->statRx = 0u;
+                for(auto& pair : conn->chanBySID) {
+                    auto chan = pair.second.lock();
+                    if(!chan)
+                        continue;
+
+                    sconn.channels.emplace_back();
+                    auto& schan = sconn.channels.back();
+                    schan.name = chan->name;
+                    schan.tx = chan->statTx;
+                    schan.rx = chan->statRx;
+
+                    if(zero) {
+                        chan->statTx = chan->statRx = 0u;
+                    }
                 }
             }
-        }
 
-    });
+        });
+    }
 
     return ret;
 }
@@ -544,6 +562,8 @@ ContextImpl::ContextImpl(const Config& conf, const evbase& tcp_loop)
 {
     searchBuckets.resize(nBuckets);
 
+    workers.emplace_back(new ClientWorker("PVXCTCP", tcp_loop));
+
     std::set<SockAddr, SockAddrOnlyLess> bcasts;
     for(auto& addr : searchTx4.broadcasts()) {
         addr.setPort(0u);
@@ -654,7 +674,7 @@ void ContextImpl::startNS()
         // start connections to name servers
         for(auto& ns : nameServers) {
             const auto& serv = ns.first;
-            ns.second = Connection::build(shared_from_this(), serv);
+            ns.second = Connection::build(shared_from_this(), *workers.front(), serv);
             ns.second->nameserver = true;
             log_debug_printf(io, "Connecting to nameserver %s\n", ns.second->peerName.c_str());
         }
@@ -679,29 +699,39 @@ void ContextImpl::close()
         (void)event_del(searchRx6.get());
         (void)event_del(beaconCleaner.get());
         (void)event_del(cacheCleaner.get());
+    });
 
-        auto conns(std::move(connByAddr));
-        // explicitly break ref. loop of channel cache
-        auto chans(std::move(chanByName));
+    for(auto& worker : workers) {
+        worker->loop.call([&worker]() {
+            auto conns(std::move(worker->connByAddr));
+            // explicitly break ref. loop of channel cache
+            auto chans(std::move(worker->chanByName));
 
-        for(auto& pair : conns) {
-            auto conn = pair.second.lock();
-            if(!conn)
-                continue;
+            for(auto& pair : conns) {
+                auto conn = pair.second.lock();
+                if(!conn)
+                    continue;
 
-            conn->cleanup();
-        }
+                conn->cleanup();
+            }
 
-        conns.clear();
-        chans.clear();
+            conns.clear();
+            chans.clear();
+        });
+    }
+
+    tcp_loop.call([this]() {
         // breaks a ref. loop between Connection and ClientContextImpl
         nameServers.clear();
+        searchByCID.clear();
 
         // internal_self.use_count() may be >1 if
         // we are orphaning some Operations
     });
 
-    tcp_loop.sync();
+    for(auto& worker : workers) {
+        worker->loop.sync();
+    }
 
     // ensure any in-progress callbacks have completed
     manager.sync();
@@ -744,6 +774,110 @@ void ContextImpl::scheduleInitialSearch()
     }
 }
 
+ClientWorker& ContextImpl::workerFor(const std::string& name) const
+{
+    if(workers.size()==1u)
+        return *workers.front();
+
+    // spread Channels across workers[1:].  Channels with the same name
+    // always share a worker, so the channel cache remains effective.
+    auto idx = 1u + std::hash<std::string>{}(name) % (workers.size()-1u);
+    return *workers[idx];
+}
+
+void ContextImpl::searchStart(const Channel& chan, size_t holdoff, bool initial)
+{
+    auto self(shared_from_this());
+    auto cid(chan.cid);
+    auto name(chan.name);
+    auto worker(chan.worker);
+
+    (void)tcp_loop.tryDispatch([self, cid, name, worker, holdoff, initial]() {
+        // on tcp_loop
+        auto& ent = self->searchByCID[cid];
+        if(!ent)
+            ent = std::make_shared<SearchEntry>(cid, name, worker);
+        ent->searching = true;
+
+        if(initial) {
+            self->initialSearchBucket.push_back(ent);
+
+            self->scheduleInitialSearch();
+
+        } else {
+            auto next = (self->currentBucket + holdoff) % nBuckets;
+
+            self->searchBuckets[next].push_back(ent);
+        }
+    });
+}
+
+void ContextImpl::searchStop(uint32_t cid)
+{
+    auto self(shared_from_this());
+
+    (void)tcp_loop.tryDispatch([self, cid]() {
+        // on tcp_loop
+        auto it = self->searchByCID.find(cid);
+        if(it!=self->searchByCID.end())
+            it->second->searching = false;
+        // searchBuckets cleaned in tickSearch()
+    });
+}
+
+void ContextImpl::searchForget(uint32_t cid)
+{
+    auto self(shared_from_this());
+
+    (void)tcp_loop.tryDispatch([self, cid]() {
+        // on tcp_loop
+        self->searchByCID.erase(cid);
+        // searchBuckets cleaned in tickSearch()
+    });
+}
+
+void ContextImpl::searchFound(ClientWorker& worker, const ServerGUID& guid, const SockAddr& serv,
+                              const std::vector<uint32_t>& cids)
+{
+    if(state!=Running)
+        return;
+
+    for(auto cid : cids) {
+        std::shared_ptr<Channel> chan;
+        {
+            auto it = worker.chanByCID.find(cid);
+            if(it==worker.chanByCID.end())
+                continue;
+
+            chan = it->second.lock();
+            if(!chan)
+                continue;
+        }
+
+        log_debug_printf(io, "Search reply for %s\n", chan->name.c_str());
+
+        if(chan->state==Channel::Searching) {
+            chan->guid = guid;
+            chan->replyAddr = serv;
+
+            chan->conn = Connection::build(shared_from_this(), worker, serv);
+
+            chan->conn->pending[chan->cid] = chan;
+            chan->state = Channel::Connecting;
+
+            chan->conn->createChannels();
+
+            searchStop(cid);
+
+        } else if(chan->guid!=guid) {
+            log_err_printf(duppv, "Duplicate PV name %s from %s and %s\n",
+                           chan->name.c_str(),
+                           chan->replyAddr.tostring().c_str(),
+                           serv.tostring().c_str());
+        }
+    }
+}
+
 void ContextImpl::onBeacon(const UDPManager::Beacon& msg)
 {
     epicsTimeStamp now;
@@ -876,6 +1010,9 @@ void procSearchReply(ContextImpl& self, const SockAddr& src, uint8_t peerVersion
     if(!found || proto!="tcp")
         return;
 
+    // group positive replies by the worker which owns each Channel
+    std::map<ClientWorker*, std::vector<uint32_t>> byWorker;
+
     for(auto n : range(nSearch)) {
         (void)n;
 
@@ -884,38 +1021,23 @@ void procSearchReply(ContextImpl& self, const SockAddr& src, uint8_t peerVersion
         if(!M.good())
             break;
 
-        std::shared_ptr<Channel> chan;
-        {
-            auto it = self.chanByCID.find(id);
-            if(it==self.chanByCID.end())
-                continue;
-
-            chan = it->second.lock();
-            if(!chan)
-                continue;
-        }
-
-        log_debug_printf(io, "Search reply for %s\n", chan->name.c_str());
-
-        if(chan->state==Channel::Searching) {
-            chan->guid = guid;
-            chan->replyAddr = serv;
-
-            chan->conn = Connection::build(self.shared_from_this(), serv);
+        auto it = self.searchByCID.find(id);
+        if(it==self.searchByCID.end())
+            continue;
 
-            chan->conn->pending[chan->cid] = chan;
-            chan->state = Channel::Connecting;
+        byWorker[it->second->worker].push_back(id);
+    }
 
-            chan->conn->createChannels();
+    for(auto& pair : byWorker) {
+        auto context(self.shared_from_this());
+        auto worker(pair.first);
+        auto cids(std::move(pair.second));
 
-        } else if(chan->guid!=guid) {
-            log_err_printf(duppv, "Duplicate PV name %s from %s and %s\n",
-                           chan->name.c_str(),
-                           chan->replyAddr.tostring().c_str(),
-                           serv.tostring().c_str());
-        }
+        (void)worker->loop.tryDispatch([context, worker, guid, serv, cids]() {
+            // on worker
+            context->searchFound(*worker, guid, serv, cids);
+        });
     }
-
 }
 
 bool ContextImpl::onSearch(evutil_socket_t fd)
@@ -981,6 +1103,12 @@ void Connection::handle_SEARCH_RESPONSE()
 {
     EvInBuf M(peerBE, segBuf.get(), 16);
 
+    if(worker!=context->workers.front().get()) {
+        // search state is owned by tcp_loop.  We only search through name servers
+        log_debug_printf(io, "Server %s ignore unexpected SEARCH_RESPONSE\n", peerName.c_str());
+        return;
+    }
+
     procSearchReply(*context, peerAddr, peerVersion, M, true);
 
     if(!M.good()) {
@@ -1075,19 +1203,19 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
         while(!bucket.empty()) {
             assert(kind != SearchKind::discover);
 
-            auto chan = bucket.front().lock();
-            if(!chan || chan->state!=Channel::Searching) {
+            auto ent = bucket.front().lock();
+            if(!ent || !ent->searching) {
                 bucket.pop_front();
                 continue;
             }
 
             auto save = M.save();
-            to_wire(M, uint32_t(chan->cid));
-            to_wire(M, chan->name);
+            to_wire(M, uint32_t(ent->cid));
+            to_wire(M, ent->name);
 
             if(!M.good()) {
                 // some absurdly long PV name?
-                log_err_printf(io, "PV name exceeds search buffer: '%s'\n", chan->name.c_str());
+                log_err_printf(io, "PV name exceeds search buffer: '%s'\n", ent->name.c_str());
                 // drop it on the floor
                 bucket.pop_front();
                 continue;
@@ -1110,7 +1238,7 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
 
             size_t ninc = 0u;
             if(kind==SearchKind::check && !poked)
-                ninc = chan->nSearch = std::min(searchBuckets.size(), chan->nSearch+1u);
+                ninc = ent->nSearch = std::min(searchBuckets.size(), ent->nSearch+1u);
             auto next = (idx + ninc)%searchBuckets.size();
             auto nextnext = (next + 1u)%searchBuckets.size();
 
@@ -1286,7 +1414,7 @@ void ContextImpl::onNSCheck()
         if(ns.second && ns.second->state != ConnBase::Disconnected) // hold-off, connecting, or connected
             continue;
 
-        ns.second = Connection::build(shared_from_this(), ns.first);
+        ns.second = Connection::build(shared_from_this(), *workers.front(), ns.first);
         ns.second->nameserver = true;
         log_debug_printf(io, "Reconnecting nameserver %s\n", ns.second->peerName.c_str());
     }
@@ -1301,8 +1429,10 @@ void ContextImpl::onNSCheckS(evutil_socket_t fd, short evt, void *raw)
     }
 }
 
-void ContextImpl::cacheClean(const std::string& name, Context::cacheAction action)
+void ContextImpl::cacheClean(ClientWorker& worker, const std::string& name, Context::cacheAction action)
 {
+    auto& chanByName = worker.chanByName;
+
     auto next(chanByName.begin()),
          end(chanByName.end());
 
@@ -1339,9 +1469,21 @@ void ContextImpl::cacheClean(const std::string& name, Context::cacheAction actio
 
 void ContextImpl::cacheCleanS(evutil_socket_t fd, short evt, void *raw)
 {
+    auto self(static_cast<ContextImpl*>(raw));
     try {
-        static_cast<ContextImpl*>(raw)->cacheClean(std::string(), Context::Clean);
-        static_cast<ContextImpl*>(raw)->tickBeaconClean();
+        for(auto& worker : self->workers) {
+            if(worker->loop.base==self->tcp_loop.base) {
+                self->cacheClean(*worker, std::string(), Context::Clean);
+
+            } else {
+                auto context(self->shared_from_this());
+                auto w(worker.get());
+                (void)w->loop.tryDispatch([context, w]() {
+                    context->cacheClean(*w, std::string(), Context::Clean);
+                });
+            }
+        }
+        self->tickBeaconClean();
     }catch(std::exception& e){
         log_exc_printf(io, "Unhandled error in beacon cleaner timer callback: %s\n", e.what());
     }
@@ -1350,7 +1492,17 @@ void ContextImpl::cacheCleanS(evutil_socket_t fd, short evt, void *raw)
 Context::Pvt::Pvt(const Config& conf)
     :loop("PVXCTCP", epicsThreadPriorityCAServerLow)
     ,impl(std::make_shared<ContextImpl>(conf, loop.internal()))
-{}
+{
+    auto nWorkers = impl->effective.nWorkers;
+    workerLoops.reserve(nWorkers);
+    impl->workers.reserve(1u + nWorkers);
+
+    for(auto i : range(nWorkers)) {
+        std::string name(SB()<<"PVXCTCP-"<<i);
+        workerLoops.emplace_back(name, epicsThreadPriorityCAServerLow);
+        impl->workers.emplace_back(new ClientWorker(name, workerLoops.back().internal()));
+    }
+}
 
 Context::Pvt::~Pvt()
 {
@@ -17,14 +17,16 @@ DEFINE_LOGGER(connsetup, "pvxs.tcp.setup");
 DEFINE_LOGGER(remote, "pvxs.remote.log");
 
 Connection::Connection(const std::shared_ptr<ContextImpl>& context,
+                       ClientWorker* worker,
                        const SockAddr& peerAddr,
                        bool reconn)
     :ConnBase (true, context->effective.sendBE(),
                nullptr,
                peerAddr)
     ,context(context)
+    ,worker(worker)
     ,echoTimer(__FILE__, __LINE__,
-               event_new(context->tcp_loop.base, -1, EV_TIMEOUT|EV_PERSIST, &tickEchoS, this))
+               event_new(worker->loop.base, -1, EV_TIMEOUT|EV_PERSIST, &tickEchoS, this))
 {
     if(reconn) {
         log_debug_printf(io, "start holdoff timer for %s\n", peerName.c_str());
@@ -45,15 +47,16 @@ Connection::~Connection()
 }
 
 std::shared_ptr<Connection> Connection::build(const std::shared_ptr<ContextImpl>& context,
+                                              ClientWorker& worker,
                                               const SockAddr& serv, bool reconn)
 {
     if(context->state!=ContextImpl::Running)
         throw std::logic_error("Context close()d");
 
     std::shared_ptr<Connection> ret;
-    auto it = context->connByAddr.find(serv);
-    if(it==context->connByAddr.end() || !(ret = it->second.lock())) {
-        context->connByAddr[serv] = ret = std::make_shared<Connection>(context, serv, reconn);
+    auto it = worker.connByAddr.find(serv);
+    if(it==worker.connByAddr.end() || !(ret = it->second.lock())) {
+        worker.connByAddr[serv] = ret = std::make_shared<Connection>(context, &worker, serv, reconn);
     }
     return ret;
 }
@@ -63,7 +66,7 @@ void Connection::startConnecting()
     assert(!this->bev);
 
     decltype(this->bev) bev(__FILE__, __LINE__,
-                bufferevent_socket_new(context->tcp_loop.base, -1,
+                bufferevent_socket_new(worker->loop.base, -1,
                                        BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS));
 
     bufferevent_setcb(bev.get(), &bevReadS, nullptr, &bevEventS, this);
@@ -169,7 +172,7 @@ void Connection::cleanup()
 {
     ready = false;
 
-    context->connByAddr.erase(peerAddr);
+    worker->connByAddr.erase(peerAddr);
 
     if(bev)
         bev.reset();
@@ -377,7 +380,7 @@ void Connection::handle_CREATE_CHANNEL()
         // server refuses to create a channel, but presumably responded positively to search
 
         chan->state = Channel::Searching;
-        context->searchBuckets[context->currentBucket].push_back(chan);
+        context->searchStart(*chan, 0u, false);
 
         log_warn_printf(io, "Server %s refuses channel to '%s' : %s\n", peerName.c_str(),
                         chan->name.c_str(), sts.msg.c_str());
@@ -32,7 +32,7 @@ struct PRBase::Args
             if(auto fld = ret[pair.first]) {
                 try {
                     auto store = Value::Helper::store(pair.second.first);
-                    fld.copyIn(static_cast<const void*>(&store->store), store->code);
+                    fld.copyIn(store->addr(), store->code);
                 }catch(NoConvert& e){
                     if(pair.second.second)
                         throw;
@@ -592,7 +592,7 @@ std::shared_ptr<Operation> gpr_setup(const std::shared_ptr<ContextImpl>& context
                        }, std::move(temp)));
     });
 
-    context->tcp_loop.dispatch([internal, context, name, server]() {
+    internal->loop.dispatch([internal, context, name, server]() {
         // on worker
 
         try {
@@ -617,7 +617,7 @@ std::shared_ptr<Operation> GetBuilder::_exec_get()
 
     auto context(ctx->impl->shared_from_this());
 
-    auto op(std::make_shared<GPROp>(Operation::Get, context->tcp_loop));
+    auto op(std::make_shared<GPROp>(Operation::Get, context->workerFor(_name).loop));
     op->setDone(std::move(_result), std::move(_onInit));
     op->autoExec = _autoexec;
     op->pvRequest = _buildReq();
@@ -632,7 +632,7 @@ std::shared_ptr<Operation> PutBuilder::exec()
 
     auto context(ctx->impl->shared_from_this());
 
-    auto op(std::make_shared<GPROp>(Operation::Put, context->tcp_loop));
+    auto op(std::make_shared<GPROp>(Operation::Put, context->workerFor(_name).loop));
     op->setDone(std::move(_result), std::move(_onInit));
 
     if(_builder) {
@@ -664,7 +664,7 @@ std::shared_ptr<Operation> RPCBuilder::exec()
 
     auto context(ctx->impl->shared_from_this());
 
-    auto op(std::make_shared<GPROp>(Operation::RPC, context->tcp_loop));
+    auto op(std::make_shared<GPROp>(Operation::RPC, context->workerFor(_name).loop));
     op->setDone(std::move(_result), nullptr);
     if(_argument) {
         if(!_autoexec)
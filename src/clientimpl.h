@@ -7,6 +7,7 @@
 #define CLIENTIMPL_H
 
 #include <list>
+#include <atomic>
 
 #include <epicsTime.h>
 #include <epicsEvent.h>
@@ -25,6 +26,7 @@ namespace client {
 
 struct Channel;
 struct ContextImpl;
+struct ClientWorker;
 
 struct ResultWaiter {
     epicsMutex lock;
@@ -62,27 +64,22 @@ struct OperationBase : public Operation
     virtual void interrupt() override final;
 };
 
-struct RequestFL {
-    const size_t limit;
-    epicsMutex lock;
-    std::vector<Value> unused;
-
-    explicit RequestFL(size_t limit) :limit(limit) {}
-};
-
 struct RequestInfo {
     const uint32_t sid, ioid;
     const Operation::operation_t op;
     const std::weak_ptr<OperationBase> handle;
 
     Value prototype;
-    std::shared_ptr<RequestFL> fl;
+    // re-usable storage for updates of prototype type
+    std::shared_ptr<impl::StructPool> pool;
 
     RequestInfo(uint32_t sid, uint32_t ioid, std::shared_ptr<OperationBase>& handle);
 };
 
 struct Connection final : public ConnBase, public std::enable_shared_from_this<Connection> {
     const std::shared_ptr<ContextImpl> context;
+    // owner of the loop servicing this Connection
+    ClientWorker* const worker;
 
     // While HoldOff, the time until re-connection
     // While Connected, periodic Echo
@@ -102,15 +99,27 @@ struct Connection final : public ConnBase, public std::enable_shared_from_this<C
 
     uint32_t nextIOID = 0x10002000u;
 
+    // MONITOR update being decoded as segments arrive
+    struct PartialMonitor {
+        uint32_t ioid;
+        uint8_t subcmd;
+        size_t consumed; // from segBuf
+        ValidDecoder decoder;
+    };
+    std::unique_ptr<PartialMonitor> rxMonitor;
+    bool rxMonitorSkip = false; // current message not decoded incrementally
+
     INST_COUNTER(Connection);
 
     Connection(const std::shared_ptr<ContextImpl>& context,
+               ClientWorker* worker,
                const SockAddr &peerAddr,
                bool reconn);
     virtual ~Connection();
 
     static
     std::shared_ptr<Connection> build(const std::shared_ptr<ContextImpl>& context,
+                                      ClientWorker& worker,
                                       const SockAddr& serv,
                                       bool reconn=false);
 
@@ -146,6 +155,8 @@ public:
 #undef CASE
 
     void handle_GPR(pva_app_msg_t cmd);
+
+    virtual void handleSegment(bool first) override final;
 protected:
     void tickEcho();
     static void tickEchoS(evutil_socket_t fd, short evt, void *raw);
@@ -173,6 +184,8 @@ struct ConnectImpl final : public Connect
 
 struct Channel {
     const std::shared_ptr<ContextImpl> context;
+    // owner of the loop servicing this Channel, and all Operations on it
+    ClientWorker* const worker;
     const std::string name;
     // Our chosen ID for this channel.
     // used as persistent CID and searchID
@@ -193,9 +206,6 @@ struct Channel {
     // channel created with .server() to bypass normal search process
     SockAddr forcedServer;
 
-    // when state==Searching, number of repetitions
-    size_t nSearch = 0u;
-
     // GUID of last positive reply when state!=Searching
     ServerGUID guid{};
     SockAddr replyAddr;
@@ -211,7 +221,8 @@ struct Channel {
 
     INST_COUNTER(Channel);
 
-    Channel(const std::shared_ptr<ContextImpl>& context, const std::string& name, uint32_t cid);
+    Channel(const std::shared_ptr<ContextImpl>& context, ClientWorker* worker,
+            const std::string& name, uint32_t cid);
     ~Channel();
 
     void createOperations();
@@ -243,6 +254,45 @@ private:
     virtual void disconnected(const std::shared_ptr<OperationBase> &self) override final;
 };
 
+// A thread servicing a subset of Channels, and the Connections they use.
+struct ClientWorker {
+    const std::string name;
+    // internal ref.  Context::Pvt holds the external ref
+    const evbase loop;
+
+    // remaining members only accessible from loop worker
+
+    std::map<uint32_t, std::weak_ptr<Channel>> chanByCID;
+    // strong ref. loop through Channel::context
+    // explicitly broken by Context::close(), Context::cacheClear(), or ContextImpl::cacheClean()
+    // chanByName key'd by (pv, forceServer)
+    std::map<std::pair<std::string, std::string>, std::shared_ptr<Channel>> chanByName;
+
+    std::map<SockAddr, std::weak_ptr<Connection>> connByAddr;
+
+    ClientWorker(const std::string& name, const evbase& loop)
+        :name(name)
+        ,loop(loop)
+    {}
+};
+
+// tcp_loop copy of the search state of a Channel, which may live on another worker
+struct SearchEntry {
+    const uint32_t cid;
+    const std::string name;
+    ClientWorker* const worker;
+
+    // when searching, number of repetitions
+    size_t nSearch = 0u;
+    bool searching = false;
+
+    SearchEntry(uint32_t cid, const std::string& name, ClientWorker* worker)
+        :cid(cid)
+        ,name(name)
+        ,worker(worker)
+    {}
+};
+
 struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
 {
     SockAttach attach;
@@ -252,13 +302,16 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
         Init,
         Running,
         Stopped,
-    } state = Init;
+    };
+    // written from tcp_loop, read from all workers
+    std::atomic<state_t> state{Init};
 
     const Config effective;
 
     const Value caMethod;
 
-    uint32_t nextCID=0x12345678;
+    // shared by all workers so that CIDs (aka. search IDs) are unique
+    std::atomic<uint32_t> nextCID{0x12345678};
     uint32_t prevndrop = 0u;
 
     evsocket searchTx4, searchTx6;
@@ -290,25 +343,26 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
     // search destination address and whether to set the unicast flag
     std::vector<std::pair<SockEndpoint, bool>> searchDest;
 
+    // search state, only accessed from tcp_loop
+    std::map<uint32_t, std::shared_ptr<SearchEntry>> searchByCID;
+
     size_t currentBucket = 0u;
     // Channels where we have yet to send out an initial search request
-    std::list<std::weak_ptr<Channel>> initialSearchBucket;
+    std::list<std::weak_ptr<SearchEntry>> initialSearchBucket;
     // Channels where we are waiting for a search response
-    std::vector<std::list<std::weak_ptr<Channel>>> searchBuckets;
+    std::vector<std::list<std::weak_ptr<SearchEntry>>> searchBuckets;
 
     std::list<std::unique_ptr<UDPListener> > beaconRx;
 
-    std::map<uint32_t, std::weak_ptr<Channel>> chanByCID;
-    // strong ref. loop through Channel::context
-    // explicitly broken by Context::close(), Context::cacheClear(), or ContextImpl::cacheClean()
-    // chanByName key'd by (pv, forceServer)
-    std::map<std::pair<std::string, std::string>, std::shared_ptr<Channel>> chanByName;
-
-    std::map<SockAddr, std::weak_ptr<Connection>> connByAddr;
-
     std::vector<std::pair<SockAddr, std::shared_ptr<Connection>>> nameServers;
 
     evbase tcp_loop;
+
+    // workers[0] services tcp_loop, and name server Connections.
+    // When effective.nWorkers==0 it also services all Channels,
+    // otherwise Channels are spread across workers[1:] by name.
+    // vector size const after Context::Pvt ctor
+    std::vector<std::unique_ptr<ClientWorker>> workers;
     const evevent searchRx4, searchRx6;
     const evevent searchTimer;
     const evevent initialSearcher;
@@ -340,6 +394,16 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
 
     void scheduleInitialSearch();
 
+    ClientWorker& workerFor(const std::string& name) const;
+
+    // called from Channel worker
+    void searchStart(const Channel& chan, size_t holdoff, bool initial);
+    void searchStop(uint32_t cid);
+    void searchForget(uint32_t cid);
+    // called on worker with search replies from tcp_loop
+    void searchFound(ClientWorker& worker, const ServerGUID& guid, const SockAddr& serv,
+                     const std::vector<uint32_t>& cids);
+
     bool onSearch(evutil_socket_t fd);
     static void onSearchS(evutil_socket_t fd, short evt, void *raw);
     enum class SearchKind { discover, initial, check };
@@ -348,7 +412,7 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
     static void initialSearchS(evutil_socket_t fd, short evt, void *raw);
     void tickBeaconClean();
     static void tickBeaconCleanS(evutil_socket_t fd, short evt, void *raw);
-    void cacheClean(const std::string &name, Context::cacheAction force);
+    void cacheClean(ClientWorker& worker, const std::string &name, Context::cacheAction force);
     static void cacheCleanS(evutil_socket_t fd, short evt, void *raw);
     void onNSCheck();
     static void onNSCheckS(evutil_socket_t fd, short evt, void *raw);
@@ -359,6 +423,8 @@ struct Context::Pvt {
     // impl directly, and indirectly, contains internal refs
 private:
     evbase loop;
+    // external refs to additional workers, when effective.nWorkers>0
+    std::vector<evbase> workerLoops;
 public:
     const std::shared_ptr<ContextImpl> impl;
 
@@ -46,6 +46,8 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
     bool pipeline = false;
     bool autostart = true;
     bool maskConn = false, maskDiscon = true;
+    // skip cache_sync()
+    bool deltas = false;
     uint32_t queueSize = 4u, ackAt=0u;
 
     // only access from loop
@@ -461,9 +463,58 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
 };
 DEFINE_INST_COUNTER(SubscriptionImpl);
 
+// Take from pool of pre-allocated Value
+static
+Value monitorValue(RequestInfo& info)
+{
+    return info.pool->create();
+}
+
+void Connection::handleSegment(bool first)
+{
+    if(first) {
+        rxMonitor.reset();
+        rxMonitorSkip = false;
+    }
+
+    if(segCmd!=CMD_MONITOR || rxMonitorSkip)
+        return;
+
+    auto before = evbuffer_get_length(segBuf.get());
+
+    if(!rxMonitor) {
+        uint8_t raw[5];
+        if(evbuffer_copyout(segBuf.get(), raw, sizeof(raw))!=sizeof(raw))
+            return;
+
+        FixedBuf M(peerBE, raw, sizeof(raw));
+        uint32_t ioid=0;
+        uint8_t subcmd=0;
+        from_wire(M, ioid);
+        from_wire(M, subcmd);
+
+        auto it = opByIOID.find(ioid);
+        if(!M.good() || (subcmd&0x18) // only plain updates.  not INIT, or final with Status
+                || it==opByIOID.end() || !it->second.pool) {
+            rxMonitorSkip = true;
+            return;
+        }
+
+        rxMonitor.reset(new PartialMonitor{ioid, subcmd, sizeof(raw), ValidDecoder(monitorValue(it->second))});
+        evbuffer_drain(segBuf.get(), sizeof(raw));
+        before -= sizeof(raw);
+    }
+
+    rxMonitor->decoder.partial(segBuf.get(), peerBE, rxRegistry);
+    rxMonitor->consumed += before - evbuffer_get_length(segBuf.get());
+}
+
 void Connection::handle_MONITOR()
 {
-    auto rxlen = 8u + evbuffer_get_length(segBuf.get());
+    // maybe partially decoded by handleSegment()
+    std::unique_ptr<PartialMonitor> partial(std::move(rxMonitor));
+
+    auto rxlen = 8u + evbuffer_get_length(segBuf.get()) + (partial ? partial->consumed : 0u);
     EvInBuf M(peerBE, segBuf.get(), 16);
 
     uint32_t ioid=0;
@@ -471,8 +522,13 @@ void Connection::handle_MONITOR()
     Status sts{};
     Value data; // hold prototype (INIT) or reply data
 
-    from_wire(M, ioid);
-    from_wire(M, subcmd);
+    if(partial) {
+        ioid = partial->ioid;
+        subcmd = partial->subcmd;
+    } else {
+        from_wire(M, ioid);
+        from_wire(M, subcmd);
+    }
     bool init = subcmd&0x08;
     bool final = subcmd&0x10;
 
@@ -502,52 +558,17 @@ void Connection::handle_MONITOR()
 
         } else if(init) {
             info->prototype = std::move(data);
-            // initialize info->fl later, with access to queueSize
-
-        } else if(!final || !M.empty()) {
-
-            // Take from free-list of pre-allocated Value
-            Value raw;
-            {
-                Guard G(info->fl->lock);
+            // initialize info->pool later, with access to queueSize
 
-                if(!info->fl->unused.empty()) {
-                    raw = std::move(info->fl->unused.back());
-                    info->fl->unused.pop_back();
+        } else if(partial || !final || !M.empty()) {
+            if(partial) {
+                partial->decoder.finish(M, rxRegistry);
+                data = std::move(partial->decoder.val);
 
-                } else {
-                    raw = info->prototype.cloneEmpty();
-                }
-            }
-            // Wrap Value for automatic return to our free-list
-            {
-                std::weak_ptr<RequestFL> wfl(info->fl);
-                auto desc(Value::Helper::desc(raw));
-                auto store(Value::Helper::store_ptr(raw));
-
-                Value::Helper::store(data).reset(
-                            store,
-                            // ugly bind() to capture by move instead of copy to avoid extra ref-counts
-                            std::bind(
-                            [](FieldStorage*, Value& data, std::weak_ptr<RequestFL>& wfl) mutable {
-                                // maybe on worker or user thread
-                                auto real(std::move(data));
-                                if(auto fl = wfl.lock()) {
-                                    Guard G(fl->lock);
-                                    if(fl->unused.size() < fl->limit) {
-                                        real.clear();
-                                        fl->unused.emplace_back(std::move(real));
-                                    }
-                                }
-
-                }, std::placeholders::_1, std::move(raw), std::move(wfl))
-                            );
-
-                Value::Helper::set_desc(data, desc);
+            } else {
+                data = monitorValue(*info);
+                from_wire_valid(M, rxRegistry, data);
             }
-            from_wire_valid(M, rxRegistry, data);
-
-            cache_sync(info->prototype, data);
 
             BitMask overrun;
             from_wire(M, overrun);
@@ -605,6 +626,9 @@ void Connection::handle_MONITOR()
 
     mon->chan->statRx += rxlen;
 
+    if(data && !init && !mon->deltas)
+        cache_sync(info->prototype, data);
+
     Entry update;
 
     if(!sts.isSuccess()) {
@@ -658,7 +682,7 @@ void Connection::handle_MONITOR()
             /* Allow enough for user to hold/process one full queue while
              * accumulate another.
              */
-            info->fl = std::make_shared<RequestFL>(2u*mon->queueSize);
+            info->pool = std::make_shared<impl::StructPool>(info->prototype, 2u*mon->queueSize);
 
         } else {
 
@@ -745,7 +769,7 @@ std::shared_ptr<Subscription> MonitorBuilder::exec()
 
     auto context(ctx->impl->shared_from_this());
 
-    auto op(std::make_shared<SubscriptionImpl>(context->tcp_loop));
+    auto op(std::make_shared<SubscriptionImpl>(context->workerFor(_name).loop));
     op->self = op;
     op->channelName = std::move(_name);
     op->event = std::move(_event);
@@ -753,6 +777,7 @@ std::shared_ptr<Subscription> MonitorBuilder::exec()
     op->pvRequest = _buildReq();
     op->maskConn = _maskConn;
     op->maskDiscon = _maskDisconn;
+    op->deltas = _deltas;
     op->autostart = _autoexec;
 
     auto options = op->pvRequest["record._options"];
@@ -814,7 +839,7 @@ std::shared_ptr<Subscription> MonitorBuilder::exec()
     });
 
     auto server(std::move(_server));
-    context->tcp_loop.dispatch([op, context, server]() {
+    op->loop.dispatch([op, context, server]() {
         // on worker
 
         try {
@@ -433,6 +433,30 @@ void _fromDefs(Config& self, const std::map<std::string, std::string>& defs, boo
     if(pickone({"EPICS_PVA_CONN_TMO"})) {
         parse_timeout(self.tcpTimeout, pickone.name, pickone.val);
     }
+
+    if(pickone({"EPICS_PVAS_TCP_WORKERS"})) {
+        try {
+            self.nWorkers = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVAS_SEARCH_CACHE_TMO"})) {
+        try {
+            self.searchCacheTimeout = parseTo<double>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid number : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVAS_SEARCH_RATE"})) {
+        try {
+            self.searchRate = parseTo<double>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid number : %s", pickone.name.c_str(), e.what());
+        }
+    }
 }
 
 Config& Config::applyEnv()
@@ -479,6 +503,9 @@ void Config::updateDefs(defs_t& defs) const
     defs["EPICS_PVA_INTF_ADDR_LIST"] = defs["EPICS_PVAS_INTF_ADDR_LIST"]   = join_addr(interfaces);
     defs["EPICS_PVAS_IGNORE_ADDR_LIST"]   = join_addr(ignoreAddrs);
     defs["EPICS_PVA_CONN_TMO"] = SB()<<tcpTimeout/tmoScale;
+    defs["EPICS_PVAS_TCP_WORKERS"] = SB()<<nWorkers;
+    defs["EPICS_PVAS_SEARCH_CACHE_TMO"] = SB()<<searchCacheTimeout;
+    defs["EPICS_PVAS_SEARCH_RATE"] = SB()<<searchRate;
 }
 
 void Config::expand()
@@ -525,6 +552,14 @@ void Config::expand()
 
     enforceTimeout(tcpTimeout);
 
+    // arbitrary sanity limit
+    if(nWorkers > 256u)
+        nWorkers = 256u;
+
+    if(!std::isfinite(searchCacheTimeout) || searchCacheTimeout < 0.0)
+        searchCacheTimeout = 0.0;
+    if(!std::isfinite(searchRate) || searchRate < 0.0)
+        searchRate = 0.0;
 }
 
 std::ostream& operator<<(std::ostream& strm, const Config& conf)
@@ -595,6 +630,14 @@ void _fromDefs(Config& self, const std::map<std::string, std::string>& defs, boo
     if(pickone({"EPICS_PVA_CONN_TMO"})) {
         parse_timeout(self.tcpTimeout, pickone.name, pickone.val);
     }
+
+    if(pickone({"EPICS_PVA_TCP_WORKERS"})) {
+        try {
+            self.nWorkers = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(clientsetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
 }
 
 Config& Config::applyEnv()
@@ -618,6 +661,7 @@ void Config::updateDefs(defs_t& defs) const
     defs["EPICS_PVA_INTF_ADDR_LIST"] = join_addr(interfaces);
     defs["EPICS_PVA_CONN_TMO"] = SB()<<tcpTimeout/tmoScale;
     defs["EPICS_PVA_NAME_SERVERS"] = join_addr(nameServers);
+    defs["EPICS_PVA_TCP_WORKERS"] = SB()<<nWorkers;
 }
 
 void Config::expand()
@@ -645,6 +689,10 @@ void Config::expand()
     printAddresses(addressList, addrs);
 
     enforceTimeout(tcpTimeout);
+
+    // arbitrary sanity limit
+    if(nWorkers > 256u)
+        nWorkers = 256u;
 }
 
 std::ostream& operator<<(std::ostream& strm, const Config& conf)
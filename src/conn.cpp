@@ -26,6 +26,10 @@ namespace impl {
 static
 constexpr size_t tcp_readahead_mult = 2u;
 
+// Longer message bodies are sent as several segments.
+static
+constexpr size_t tcp_tx_segment = 1u<<20u;
+
 ConnBase::ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr& peerAddr)
     :peerAddr(peerAddr)
     ,peerName(peerAddr.tostring())
@@ -37,6 +41,7 @@ ConnBase::ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr&
     ,segCmd(0xff)
     ,segBuf(__FILE__, __LINE__, evbuffer_new())
     ,txBody(__FILE__, __LINE__, evbuffer_new())
+    ,maxTxSegment(tcp_tx_segment)
     ,state(Holdoff)
 {
     if(bev) { // true for server connection.  client will call connect() shortly
@@ -88,18 +93,20 @@ void ConnBase::disconnect()
 
 size_t ConnBase::enqueueTxBody(pva_app_msg_t cmd)
 {
-    auto blen = evbuffer_get_length(txBody.get());
     auto tx = bufferevent_get_output(bev.get());
-    to_evbuf(tx, Header{cmd,
-                        uint8_t(isClient ? 0u : pva_flags::Server),
-                        uint32_t(blen)},
-             sendBE);
-    auto err = evbuffer_add_buffer(tx, txBody.get());
-    assert(!err); // could only fail if frozen/pinned, which is not the case
-    statTx += 8u + blen;
-    return 8u + blen;
+    auto ntx = to_evbuf(tx,
+                        Header{cmd,
+                               uint8_t(isClient ? 0u : pva_flags::Server),
+                               0u},
+                        txBody.get(),
+                        sendBE,
+                        maxTxSegment);
+    statTx += ntx;
+    return ntx;
 }
 
+void ConnBase::handleSegment(bool first) {}
+
 #define CASE(Op) void ConnBase::handle_##Op() {}
     CASE(ECHO);
     CASE(CONNECTION_VALIDATION);
@@ -221,9 +228,9 @@ void ConnBase::bevRead()
         remaining -= 8u + len;
         statRx += 8u + len;
 
-        // so far we do not use segmentation to support incremental processing
-        // of long messages.  We instead accumulate all segments of a message
-        // prior to parsing.
+        // All segments of a message are accumulated in segBuf prior to
+        // processing by handle_*().  handleSegment() may begin incremental
+        // processing of long messages, consuming some of segBuf.
 
         auto seg = header[2]&pva_flags::SegMask;
 
@@ -241,6 +248,17 @@ void ConnBase::bevRead()
             segCmd = header[3];
         }
 
+        if(seg==pva_flags::SegFirst || seg==pva_flags::SegMask) {
+            try {
+                handleSegment(seg==pva_flags::SegFirst);
+            }catch(std::exception& e){
+                log_exc_printf(connio, "%s Error while processing segment of cmd 0x%02x: %s\n",
+                               peerLabel(), segCmd, e.what());
+                bev.reset();
+                break;
+            }
+        }
+
         if(!seg || seg==pva_flags::SegLast) {
             expectSeg = false;
 
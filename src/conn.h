@@ -42,6 +42,8 @@ public:
 
     size_t statTx{}, statRx{};
     size_t readahead{};
+    // longest message body sent without segmentation
+    size_t maxTxSegment;
 
     enum {
         Holdoff,
@@ -88,6 +90,10 @@ protected:
     CASE(MESSAGE);
 #undef CASE
 
+    // Called after each segment of an incomplete message is appended to segBuf.
+    // May begin processing, leaving the remainder for handle_*()
+    virtual void handleSegment(bool first);
+
     virtual std::shared_ptr<ConnBase> self_from_this() =0;
     virtual void cleanup() =0;
     virtual void bevEvent(short events);
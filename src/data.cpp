@@ -4,8 +4,12 @@
  * in file LICENSE that is included with this distribution.
  */
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <new>
 #include <epicsAssert.h>
+#include <epicsGuard.h>
 
 #include "dataimpl.h"
 #include "utilpvt.h"
@@ -33,7 +37,7 @@ std::shared_ptr<const impl::FieldDesc>
 Value::Helper::type(const Value& v)
 {
     if(v) {
-        return std::shared_ptr<const impl::FieldDesc>(v.store->top->desc, v.desc);
+        return std::shared_ptr<const impl::FieldDesc>(v.store->top()->desc, v.desc);
     } else {
         return nullptr;
     }
@@ -93,28 +97,65 @@ Value Value::Helper::build(const void* ptr, StoreType type)
     return ret;
 }
 
-Value::Value(const std::shared_ptr<const impl::FieldDesc>& desc)
-    :desc(nullptr)
-{
-    if(!desc)
-        return;
-
-    auto top = std::make_shared<StructTop>(desc);
+namespace {
+typedef epicsGuard<epicsMutex> Guard;
 
+void initTop(StructTop* top)
+{
+    auto& desc = top->desc;
     {
         auto& root = top->members[0];
         root.init(desc->code.storedAs());
-        root.top = top.get();
     }
 
     if(desc->code==TypeCode::Struct) {
         for(auto& pair : desc->mlookup) {
             auto cfld = desc.get() + pair.second;
             auto& mem = top->members.at(pair.second);
-            mem.top = top.get();
             mem.init(cfld->code.storedAs());
         }
     }
+}
+
+// un-mark, and reset to zero/empty, while retaining allocated capacity of strings
+void clearStorage(FieldStorage* mems, size_t count)
+{
+    for(auto i : range(count)) {
+        auto& s = mems[i];
+        s.setValid(false);
+
+        switch(s.code) {
+        case StoreType::Array:
+            s.as<shared_array<const void>>().clear();
+            break;
+        case StoreType::Compound:
+            s.as<Value>() = Value();
+            break;
+        case StoreType::String:
+            s.as<std::string>().clear();
+            break;
+        case StoreType::Null:
+            break; // nothing to do
+        case StoreType::Bool:
+        case StoreType::UInteger:
+        case StoreType::Integer:
+        case StoreType::Real:
+            memset(&s.store, 0, sizeof(s.store)); // just zero
+            break;
+        }
+    }
+}
+} // namespace
+
+Value::Value(const std::shared_ptr<const impl::FieldDesc>& desc)
+    :desc(nullptr)
+{
+    if(!desc)
+        return;
+
+    auto top = std::make_shared<StructTop>(desc);
+
+    initTop(top.get());
 
     this->desc = desc.get();
     decltype (store) val(top, top->members.data()); // alias
@@ -124,7 +165,7 @@ Value::Value(const std::shared_ptr<const impl::FieldDesc>& desc)
 Value::Value(const std::shared_ptr<const impl::FieldDesc>& desc, Value& parent)
     :Value(desc)
 {
-    store->top->enclosing = parent.store;
+    store->top()->enclosing = parent.store;
 }
 
 Value::~Value() {}
@@ -133,7 +174,7 @@ Value Value::cloneEmpty() const
 {
     Value ret;
     if(desc) {
-        decltype (store->top->desc) fld(store->top->desc, desc);
+        decltype (store->top()->desc) fld(store->top()->desc, desc);
         ret = Value(fld);
     }
     return ret;
@@ -143,7 +184,7 @@ Value Value::clone() const
 {
     Value ret;
     if(desc) {
-        decltype (store->top->desc) fld(store->top->desc, desc);
+        decltype (store->top()->desc) fld(store->top()->desc, desc);
         ret = Value(fld);
         ret.assign(*this);
     }
@@ -160,7 +201,7 @@ Value& Value::assign(const Value& o)
         copyIn(&o, StoreType::Compound);
     } else {
         // unpack other field types
-        copyIn(o.store.get(), o.store->code);
+        copyIn(o.store->addr(), o.store->code);
     }
     return *this;
 }
@@ -171,7 +212,7 @@ Value Value::allocMember()
     if(!desc || (desc->code!=TypeCode::UnionA && desc->code!=TypeCode::StructA))
         throw std::runtime_error("allocMember() only meaningful for Struct[] or Union[]");
 
-    decltype (store->top->desc) fld(store->top->desc, desc->members.data());
+    decltype (store->top()->desc) fld(store->top()->desc, desc->members.data());
     return Value::Helper::build(fld, *this);
 }
 
@@ -180,34 +221,7 @@ void Value::clear()
     if(!desc)
         return;
 
-    for(auto i : range(size_t(0u), desc->size())) {
-        auto& s = store.get()[i];
-        s.valid = false;
-
-        switch(s.code) {
-        case StoreType::Array:
-            s.as<shared_array<const void>>().clear();
-            break;
-        case StoreType::Compound:
-        {
-            auto& v = s.as<Value>();
-            v.desc = nullptr;
-            v.store.reset();
-        }
-            break;
-        case StoreType::String:
-            s.as<std::string>().clear();
-            break;
-        case StoreType::Null:
-            break; // nothing to do
-        case StoreType::Bool:
-        case StoreType::UInteger:
-        case StoreType::Integer:
-        case StoreType::Real:
-            memset(&s.store, 0, sizeof(s.store)); // just zero
-            break;
-        }
-    }
+    clearStorage(store.get(), desc->size());
 }
 
 bool Value::isMarked(bool parents, bool children) const
@@ -218,7 +232,7 @@ bool Value::isMarked(bool parents, bool children) const
     if(store->valid)
         return true;
 
-    auto top = store->top;
+    auto top = store->top();
 
     if(children && desc->size()>1u) {
         // TODO more efficient
@@ -258,15 +272,15 @@ void Value::mark(bool v)
     if(!desc)
         return;
 
-    store->valid = v;
+    store->setValid(v);
     if(!v)
         return;
 
-    auto top = store->top;
+    auto top = store->top();
     std::shared_ptr<FieldStorage> enc;
     while(top && (enc=top->enclosing.lock())) {
-        enc->valid = true;
-        top = enc->top;
+        enc->setValid(true);
+        top = enc->top();
     }
 }
 
@@ -275,15 +289,14 @@ void Value::unmark(bool parents, bool children)
     if(!desc)
         return;
 
-    store->valid = false;
+    store->setValid(false);
 
-    auto top = store->top;
+    auto top = store->top();
 
     if(children && desc->size()>1u) {
-        // TODO more efficient
         for(auto bit : range(desc->size()))
         {
-            (store.get() + bit)->valid = false;
+            (store.get() + bit)->setValid(false);
         }
     }
 
@@ -294,7 +307,7 @@ void Value::unmark(bool parents, bool children)
             pstore -= pdesc->parent_index;
             pdesc -= pdesc->parent_index;
 
-            pstore->valid = false;
+            pstore->setValid(false);
         }
     }
 }
@@ -692,7 +705,7 @@ void Value::copyIn(const void *ptr, StoreType type)
                     if(!_equal(src.desc, &desc->members[idx]))
                         continue;
 
-                    std::shared_ptr<const FieldDesc> udesc(store->top->desc, &desc->members[idx]);
+                    std::shared_ptr<const FieldDesc> udesc(store->top()->desc, &desc->members[idx]);
                     Value temp(udesc, *this);
                     temp.assign(src);
                     val = std::move(temp);
@@ -707,7 +720,7 @@ void Value::copyIn(const void *ptr, StoreType type)
                 // attempt convenient, but inefficient auto-selection
                 for(auto i : range(desc->miter.size())) {
                     auto idx(desc->miter[i].second);
-                    std::shared_ptr<const FieldDesc> udesc(store->top->desc, &desc->members[idx]);
+                    std::shared_ptr<const FieldDesc> udesc(store->top()->desc, &desc->members[idx]);
                     Value temp(udesc, *this);
                     try{
                         temp.copyIn(ptr, type);
@@ -747,7 +760,7 @@ void Value::copyIn(const void *ptr, StoreType type)
                         auto& name(src.nameOf(sfld));
                         if(auto dfld = (*this)[name]) {
                             try {
-                                dfld.copyIn(&sfld.store->store, sfld.store->code);
+                                dfld.copyIn(sfld.store->addr(), sfld.store->code);
                             }catch(NoConvert& e){
                                 throw NoConvert(SB()<<"field \""<<name<<"\" : "<<e.what());
                             }
@@ -788,7 +801,7 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
     while(desc && pos<expr.size()) {
         if(expr[pos]=='<') {
             // attempt traverse to parent
-            if(desc!=store->top->desc.get())
+            if(desc!=store->top()->desc.get())
             {
                 auto pdesc = desc - desc->parent_index;
                 std::shared_ptr<FieldStorage> pstore(store, store.get() - desc->parent_index);
@@ -825,12 +838,11 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
             }
 
             size_t sep = expr.find_first_of("<[-", pos);
+            const size_t len = std::min(sep, expr.size())-pos;
 
             decltype (desc->mlookup)::const_iterator it;
 
-            const auto& name = expr.substr(pos, sep-pos);
-
-            if(sep>0 && (it=desc->mlookup.find(name))!=desc->mlookup.end()) {
+            if(sep>0 && (it=desc->mlookup.find(expr.data()+pos, len))!=desc->mlookup.end()) {
                 // found it
                 auto next = desc+it->second;
                 decltype(store) value(store, store.get()+it->second);
@@ -843,6 +855,7 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
                 store.reset();
                 desc = nullptr;
                 if(dothrow) {
+                    const auto name(expr.substr(pos, len));
                     SB msg;
                     msg<<"no such member field '"<<name<<"'";
                     if(name!=expr)
@@ -871,14 +884,14 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
                     decltype (desc->mlookup)::const_iterator it;
                     auto& fld = store->as<Value>();
 
-                    if(sep>0 && (it=desc->mlookup.find(expr.substr(pos, sep-pos)))!=desc->mlookup.end()) {
+                    if(sep>0 && (it=desc->mlookup.find(expr.data()+pos, std::min(sep, expr.size())-pos))!=desc->mlookup.end()) {
                         // found it.
 
                         if(modify || fld.desc==&desc->members[it->second]) {
                             // will select, or already selected
                             if(fld.desc!=&desc->members[it->second]) {
                                 // select
-                                std::shared_ptr<const FieldDesc> mtype(store->top->desc, &desc->members[it->second]);
+                                std::shared_ptr<const FieldDesc> mtype(store->top()->desc, &desc->members[it->second]);
                                 fld = Value(mtype, *this);
                             }
                             pos = sep;
@@ -990,6 +1003,108 @@ const Value Value::lookup(const std::string& name) const
     return ret;
 }
 
+FieldHandle Value::handle(const std::string& name) const
+{
+    auto fld(lookup(name));
+
+    FieldHandle ret;
+    ret._name = name;
+    if(fld.store->top()==store->top() && fld.desc > desc) {
+        // a member of the same StructTop
+        ret.base = decltype(ret.base)(store->top()->desc, desc);
+        ret.offset = fld.desc - desc;
+    }
+    return ret;
+}
+
+Value Value::operator[](const FieldHandle& handle)
+{
+    if(desc && desc==handle.base.get()) {
+        Value ret;
+        ret.store = decltype(store)(store, store.get()+handle.offset);
+        ret.desc = desc+handle.offset;
+        return ret;
+    } else if(!handle.valid()) {
+        return Value();
+    }
+    return (*this)[handle._name];
+}
+
+const Value Value::operator[](const FieldHandle& handle) const
+{
+    if(desc && desc==handle.base.get()) {
+        Value ret;
+        ret.store = decltype(store)(store, store.get()+handle.offset);
+        ret.desc = desc+handle.offset;
+        return ret;
+    } else if(!handle.valid()) {
+        return Value();
+    }
+    return (*this)[handle._name];
+}
+
+void Value::copyOut(const FieldHandle& handle, void *ptr, StoreType type) const
+{
+    if(desc && desc==handle.base.get() && desc[handle.offset].code.kind()!=Kind::Compound) {
+        // avoid reference counting, and copyOut() won't take a reference
+        Value fld;
+        fld.store = decltype(store)(decltype(store)(), store.get()+handle.offset);
+        fld.desc = desc+handle.offset;
+        fld.copyOut(ptr, type);
+        return;
+    }
+    (*this)[handle].copyOut(ptr, type);
+}
+
+bool Value::tryCopyOut(const FieldHandle& handle, void *ptr, StoreType type) const
+{
+    try {
+        copyOut(handle, ptr, type);
+        return true;
+    }catch(NoField&){
+        return false;
+    }catch(NoConvert&){
+        return false;
+    }
+}
+
+void Value::copyIn(const FieldHandle& handle, const void *ptr, StoreType type)
+{
+    if(desc && desc==handle.base.get() && desc[handle.offset].code.kind()!=Kind::Compound) {
+        // avoid reference counting, and copyIn() of a non-Compound won't take a reference
+        Value fld;
+        fld.store = decltype(store)(decltype(store)(), store.get()+handle.offset);
+        fld.desc = desc+handle.offset;
+        fld.copyIn(ptr, type);
+        return;
+    }
+    (*this)[handle].copyIn(ptr, type);
+}
+
+namespace impl {
+void checkFieldRef(const Value& fld, const std::string& name, StoreType type)
+{
+    auto ftype = fld.storageType();
+    bool ok;
+    switch(ftype) {
+    case StoreType::Null: // Struct.  use Value::operator[](const FieldHandle&)
+        ok = false;
+        break;
+    case StoreType::Compound: // Union or Any may (auto-)select a member
+        ok = true;
+        break;
+    case StoreType::Array:
+        ok = type==StoreType::Array || type==StoreType::Compound;
+        break;
+    default: // scalar or string
+        ok = type!=StoreType::Array;
+        break;
+    }
+    if(!ok)
+        throw NoConvert(SB()<<"field \""<<name<<"\" "<<fld.type()<<" can not be accessed as "<<type);
+}
+} // namespace impl
+
 size_t Value::nmembers() const
 {
     switch(desc ? desc->code.code : TypeCode::Null) {
@@ -1242,6 +1357,9 @@ namespace impl {
 void FieldStorage::init(StoreType code)
 {
     this->code = code;
+#ifdef PVXS_COMPACT_STORAGE
+    as<void*>() = nullptr; // in case allocation fails
+#endif
     switch(code) {
     case StoreType::Null:
         return;
@@ -1254,6 +1372,17 @@ void FieldStorage::init(StoreType code)
         // just zero 8 bytes
         as<uint64_t>() = 0u;
         return;
+#ifdef PVXS_COMPACT_STORAGE
+    case StoreType::String:
+        as<void*>() = new std::string();
+        return;
+    case StoreType::Compound:
+        as<void*>() = new Value();
+        return;
+    case StoreType::Array:
+        as<void*>() = new shared_array<void>();
+        return;
+#else
     case StoreType::String:
         new(&store) std::string();
         return;
@@ -1263,6 +1392,7 @@ void FieldStorage::init(StoreType code)
     case StoreType::Array:
         new(&store) shared_array<void>();
         return;
+#endif
     }
     throw std::logic_error("FieldStore::init()");
 }
@@ -1276,6 +1406,17 @@ void FieldStorage::deinit()
     case StoreType::Real:
     case StoreType::Bool:
              break;
+#ifdef PVXS_COMPACT_STORAGE
+    case StoreType::Array:
+        delete static_cast<shared_array<void>*>(as<void*>());
+        break;
+    case StoreType::String:
+        delete static_cast<std::string*>(as<void*>());
+        break;
+    case StoreType::Compound:
+        delete static_cast<Value*>(as<void*>());
+        break;
+#else
     case StoreType::Array:
         as<shared_array<void>>().~shared_array();
         break;
@@ -1285,6 +1426,7 @@ void FieldStorage::deinit()
     case StoreType::Compound:
         as<Value>().~Value();
         break;
+#endif
     default:
         throw std::logic_error("FieldStore::deinit()");
     }
@@ -1296,10 +1438,181 @@ FieldStorage::~FieldStorage()
     deinit();
 }
 
-size_t FieldStorage::index() const
+void collectValid(BitMask& mask, const FieldStorage* store, size_t nfields)
+{
+    mask.resize(nfields);
+    if(!nfields)
+        return;
+
+    // copy bits [store->index(), store->index()+nfields) of the dense valid words
+    auto first = store - store->index();
+    auto src = FieldArray::validWordsOf(first);
+    auto srcEnd = FieldArray::nwords(store->index() + nfields);
+    auto w0 = store->index()/64u;
+    auto shift = store->index()%64u;
+
+    for(size_t w=0u, N=mask.wsize(); w<N; w++) {
+        uint64_t word = src[w0+w] >> shift;
+        if(shift && w0+w+1u < srcEnd)
+            word |= src[w0+w+1u] << (64u-shift);
+        mask.word(w) = word;
+    }
+    if(auto extra = nfields%64u) // ignore any following fields
+        mask.word(mask.wsize()-1u) &= ~(~uint64_t(0u) << extra);
+}
+
+FieldArray::FieldArray(StructTop* top, size_t count)
 {
-    const size_t ret = this - top->members.data();
+    if(count > std::numeric_limits<uint32_t>::max())
+        throw std::logic_error("Too many fields");
+
+    static_assert(sizeof(FieldStorage)%alignof(uint64_t)==0, "validWords() must follow FieldStorage");
+
+    auto raw = static_cast<Header*>(::operator new(sizeof(Header)
+                                                   + count*sizeof(FieldStorage)
+                                                   + nwords(count)*sizeof(uint64_t)));
+    raw->top = top;
+    raw->count = count;
+    first = reinterpret_cast<FieldStorage*>(raw+1);
+    memset(validWords(), 0, nwords(count)*sizeof(uint64_t));
+
+    for(auto i : range(count)) {
+        new(&first[i]) FieldStorage();
+        first[i].idx = uint32_t(i);
+    }
+}
+
+FieldArray::~FieldArray()
+{
+    for(auto& fld : *this)
+        fld.~FieldStorage();
+    ::operator delete(&reinterpret_cast<Header*>(first)[-1]);
+}
+
+// allocate shared_ptr control blocks from a StructPool
+template<typename T>
+struct StructPoolAlloc {
+    typedef T value_type;
+
+    std::shared_ptr<StructPool> pool;
+
+    explicit StructPoolAlloc(std::shared_ptr<StructPool>&& pool) :pool(std::move(pool)) {}
+    template<typename U>
+    StructPoolAlloc(const StructPoolAlloc<U>& o) :pool(o.pool) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(pool->allocBlock(n*sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) {
+        pool->freeBlock(p, n*sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const StructPoolAlloc<U>& o) const { return pool==o.pool; }
+    template<typename U>
+    bool operator!=(const StructPoolAlloc<U>& o) const { return pool!=o.pool; }
+};
+
+// shared_ptr deleter.  The StructPoolAlloc in the same control block keeps the pool alive.
+struct StructPoolRelease {
+    StructPool* pool;
+    void operator()(StructTop* top) const {
+        pool->release(top);
+    }
+};
+
+StructPool::StructPool(const Value& prototype, size_t limit)
+    :type(Value::Helper::type(prototype))
+    ,limit(limit)
+{
+    if(!type)
+        throw std::logic_error("StructPool requires a prototype");
+    // so release() and freeBlock() need not allocate
+    tops.reserve(limit);
+    blocks.reserve(limit);
+}
+
+StructPool::~StructPool()
+{
+    for(auto top : tops)
+        delete top;
+    for(auto block : blocks)
+        ::operator delete(block);
+}
+
+Value StructPool::create()
+{
+    StructTop* top = nullptr;
+    {
+        Guard G(lock);
+        if(!tops.empty()) {
+            top = tops.back();
+            tops.pop_back();
+        }
+    }
+    if(!top) {
+        std::unique_ptr<StructTop> temp(new StructTop(type));
+        initTop(temp.get());
+        top = temp.release();
+    }
+
+    // on failure, shared_ptr ctor calls StructPoolRelease
+    std::shared_ptr<StructTop> stop(top, StructPoolRelease{this},
+                                    StructPoolAlloc<StructTop>(shared_from_this()));
+
+    Value ret;
+    Value::Helper::store(ret) = std::shared_ptr<FieldStorage>(stop, top->members.data()); // alias
+    Value::Helper::set_desc(ret, type.get());
     return ret;
 }
 
+size_t StructPool::nfree() const
+{
+    Guard G(lock);
+    return tops.size();
+}
+
+void* StructPool::allocBlock(size_t nbytes)
+{
+    {
+        Guard G(lock);
+        if(nbytes==blockSize && !blocks.empty()) {
+            auto ret = blocks.back();
+            blocks.pop_back();
+            return ret;
+        }
+    }
+    return ::operator new(nbytes);
+}
+
+void StructPool::freeBlock(void* block, size_t nbytes)
+{
+    {
+        Guard G(lock);
+        if(!blockSize)
+            blockSize = nbytes;
+        if(nbytes==blockSize && blocks.size() < limit) {
+            blocks.push_back(block);
+            return;
+        }
+    }
+    ::operator delete(block);
+}
+
+void StructPool::release(StructTop* top)
+{
+    // maybe on worker or user thread
+    clearStorage(top->members.data(), top->members.size());
+    top->enclosing.reset();
+    top->encoded.reset();
+    {
+        Guard G(lock);
+        if(tops.size() < limit) {
+            tops.push_back(top);
+            return;
+        }
+    }
+    delete top;
+}
+
 }} // namespace pvxs::impl
@@ -8,6 +8,10 @@
 #define DATAENCODE_H
 
 #include <cassert>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
 
 #include <stdexcept>
 #include <functional>
@@ -18,6 +22,8 @@
 #include <type_traits>
 #include <memory>
 
+#include <epicsGuard.h>
+
 #include <pvxs/data.h>
 #include <pvxs/sharedArray.h>
 #include "pvaproto.h"
@@ -27,6 +33,8 @@
 namespace pvxs {
 namespace impl {
 
+typedef epicsGuard<epicsMutex> Guard;
+
 void to_wire(Buffer& buf, const FieldDesc* cur)
 {
     if(!cur) {
@@ -171,16 +179,9 @@ void from_wire(Buffer& buf, std::vector<FieldDesc>& descs, TypeStore& cache, uns
 
                 // update field refs.
                 fld.miter.emplace_back(name, cindex-cref);
-                fld.mlookup[name] = cindex-cref;
-                name+='.';
-
-                if(code.code==TypeCode::Struct && code==cfld.code) {
-                    // copy descendant indices for sub-struct
-                    for(auto& pair : cfld.mlookup) {
-                        fld.mlookup[name+pair.first] = cindex - cref + pair.second;
-                    }
-                }
             }
+            // includes descendant indices of sub-structs
+            descs[index].buildLookup();
         }
             break;
         default:
@@ -211,7 +212,7 @@ void from_wire(Buffer& buf, std::vector<FieldDesc>& descs, TypeStore& cache, uns
 
 // serialize a field and all children (if Compound)
 static
-void to_wire_field(Buffer& buf, const FieldDesc* desc, const std::shared_ptr<const FieldStorage>& store)
+void to_wire_field(Buffer& buf, const FieldDesc* desc, const FieldStorage* store)
 {
     switch(store->code) {
     case StoreType::Null:
@@ -222,8 +223,7 @@ void to_wire_field(Buffer& buf, const FieldDesc* desc, const std::shared_ptr<con
                 auto cdesc = desc + off;
                 if(cdesc->code==TypeCode::Struct) // skip sub-struct nodes.  Would be redundant
                     continue;
-                std::shared_ptr<const FieldStorage> cstore(store, store.get()+off); // TODO avoid shared_ptr/aliasing here
-                to_wire_field(buf, cdesc, cstore);
+                to_wire_field(buf, cdesc, store+off);
             }
         }
             return;
@@ -408,32 +408,340 @@ void to_wire_full(Buffer& buf, const Value& val)
 {
     assert(!!val);
 
-    to_wire_field(buf, Value::Helper::desc(val), Value::Helper::store(val));
+    to_wire_field(buf, Value::Helper::desc(val), Value::Helper::store_ptr(val));
 }
 
 void to_wire_valid(Buffer& buf, const Value& val, const BitMask* mask)
 {
     auto desc = Value::Helper::desc(val);
-    auto store = Value::Helper::store(val);
+    auto store = Value::Helper::store_ptr(val);
     assert(desc && desc->code==TypeCode::Struct);
     assert(!mask || mask->size()==desc->size());
 
+    const size_t N = desc->size();
+
+    BitMask marked;
+    collectValid(marked, store, N);
+    if(mask)
+        marked &= *mask;
+
+    // keep only the outermost of nested marked fields
+    BitMask valid(N);
+    size_t skip = 0u;
+    for(auto bit : marked.onlySet()) {
+        if(bit < skip)
+            continue; // within sub-struct already marked
+        valid[bit] = true;
+        skip = bit + desc[bit].size();
+    }
+
+    to_wire(buf, valid);
+
+    for(auto bit : valid.onlySet()) {
+        to_wire_field(buf, desc+bit, store+bit);
+    }
+}
+
+namespace {
+template<typename Wire, typename Stored>
+void encodeAs(Buffer& buf, const FieldDesc* desc, const FieldStorage* store)
+{
+    to_wire(buf, Wire(store->as<Stored>()));
+}
+
+void encodeString(Buffer& buf, const FieldDesc* desc, const FieldStorage* store)
+{
+    to_wire(buf, store->as<std::string>());
+}
+
+// arrays and Compound
+void encodeField(Buffer& buf, const FieldDesc* desc, const FieldStorage* store)
+{
+    to_wire_field(buf, desc, store);
+}
+
+EncodePlan::encoder_t pickEncoder(TypeCode code)
+{
+    switch(code.code) {
+    case TypeCode::Bool:    return &encodeAs<uint8_t, bool>;
+    case TypeCode::Int8:    return &encodeAs<int8_t, int64_t>;
+    case TypeCode::Int16:   return &encodeAs<int16_t, int64_t>;
+    case TypeCode::Int32:   return &encodeAs<int32_t, int64_t>;
+    case TypeCode::Int64:   return &encodeAs<int64_t, int64_t>;
+    case TypeCode::UInt8:   return &encodeAs<uint8_t, uint64_t>;
+    case TypeCode::UInt16:  return &encodeAs<uint16_t, uint64_t>;
+    case TypeCode::UInt32:  return &encodeAs<uint32_t, uint64_t>;
+    case TypeCode::UInt64:  return &encodeAs<uint64_t, uint64_t>;
+    case TypeCode::Float32: return &encodeAs<float, double>;
+    case TypeCode::Float64: return &encodeAs<double, double>;
+    case TypeCode::String:  return &encodeString;
+    default:                return &encodeField;
+    }
+}
+} // namespace
+
+EncodePlan::EncodePlan(const Type& type, BitMask&& mask)
+    :type(type)
+    ,mask(std::move(mask))
+{
+    auto desc = type.get();
+    assert(desc && desc->code==TypeCode::Struct);
+    const auto N = desc->size();
+    assert(this->mask.size()==N);
+
+    // firstOp[i] is the first element of ops with index>=i
+    std::vector<size_t> firstOp(N+1u);
+    for(auto i : range(N)) {
+        firstOp[i] = ops.size();
+        if(desc[i].code!=TypeCode::Struct) // sub-struct nodes are never serialized themselves
+            ops.push_back(Op{i, pickEncoder(desc[i].code)});
+    }
+    firstOp[N] = ops.size();
+
+    for(auto i : range(N)) {
+        if(!this->mask[i])
+            continue;
+        steps.push_back(Step{i, 0u, firstOp[i], firstOp[i + desc[i].size()]});
+    }
+
+    for(auto s : range(steps.size())) {
+        auto end = steps[s].index + desc[steps[s].index].size();
+        auto next = s+1u;
+        while(next<steps.size() && steps[next].index<end)
+            next++;
+        steps[s].next = next;
+    }
+}
+
+static
+void to_wire_planned(Buffer& buf, const FieldDesc* desc, const FieldStorage* store, const EncodePlan& plan)
+{
     BitMask valid(desc->size());
 
-    for(size_t bit=0u, N=desc->size(); bit<N;) {
-        if(store.get()[bit].valid && (!mask || (*mask)[bit])) {
-            valid[bit] = true;
-            bit += desc[bit].size(); // maybe skip past entire sub-struct
+    for(size_t s=0u, N=plan.steps.size(); s<N;) {
+        auto& step = plan.steps[s];
+        if(store[step.index].valid) {
+            valid[step.index] = true;
+            s = step.next; // maybe skip past entire sub-struct
         } else {
-            bit++;
+            s++;
         }
     }
 
     to_wire(buf, valid);
 
-    for(auto bit : valid.onlySet()) {
-        std::shared_ptr<const FieldStorage> cstore(store, store.get()+bit);
-        to_wire_field(buf, desc+bit, cstore);
+    for(size_t s=0u, N=plan.steps.size(); s<N;) {
+        auto& step = plan.steps[s];
+        if(valid[step.index]) {
+            for(auto o : range(step.opBegin, step.opEnd)) {
+                auto& op = plan.ops[o];
+                (*op.fn)(buf, desc + op.index, store + op.index);
+            }
+            s = step.next;
+        } else {
+            s++;
+        }
+    }
+}
+
+namespace {
+// Collects an encoding as a list of pieces.  Large arrays are referenced, not copied.
+struct PieceOutBuf final : public Buffer
+{
+    std::vector<EncodeCache::Piece>& pieces;
+    std::shared_ptr<std::vector<uint8_t>> cur;
+
+    PieceOutBuf(bool be, std::vector<EncodeCache::Piece>& pieces)
+        :Buffer(be, nullptr, 0)
+        ,pieces(pieces)
+    {}
+    virtual ~PieceOutBuf() {}
+
+    // move bytes written so far into a new piece
+    void flush()
+    {
+        if(!cur)
+            return;
+        size_t nbytes = pos - cur->data();
+        if(nbytes)
+            pieces.push_back(EncodeCache::Piece{
+                                 shared_array_static_cast<const void>(shared_array<const uint8_t>(cur, cur->data(), nbytes)),
+                                 nbytes});
+        cur.reset();
+        pos = limit = nullptr;
+    }
+
+    virtual bool refill(size_t more) override final
+    {
+        if(err) return false;
+
+        if(!cur)
+            cur = std::make_shared<std::vector<uint8_t>>();
+
+        more = ((more-1)|0xff)+1; // round up to multiple of 256
+        size_t idx = pos ? pos - cur->data() : 0u;
+        try{
+            cur->resize(cur->size()+more);
+        }catch(std::bad_alloc& e) {
+            return false;
+        }
+        pos = cur->data()+idx;
+        limit = cur->data()+cur->size();
+        return true;
+    }
+
+    virtual bool reference(const shared_array<const void>& arr, size_t nbytes) override final
+    {
+        if(err) return false;
+
+        flush();
+        pieces.push_back(EncodeCache::Piece{arr, nbytes});
+        return true;
+    }
+};
+} // namespace
+
+void shareEncoding(const Value& val)
+{
+    auto store = Value::Helper::store_ptr(val);
+    if(!store || store!=&store->top()->members[0])
+        throw std::logic_error("shareEncoding() requires a top level Value");
+
+    if(!store->top()->encoded)
+        store->top()->encoded.reset(new EncodeCache());
+}
+
+bool isEncodingShared(const Value& val)
+{
+    auto store = Value::Helper::store_ptr(val);
+    return store && store->top()->encoded;
+}
+
+Value SnapshotPool::snapshot(const Value& val)
+{
+    auto desc = Value::Helper::desc(val);
+
+    for(auto& prev : spare) {
+        if(Value::Helper::desc(prev)!=desc || Value::Helper::store(prev).use_count()!=1)
+            continue;
+        // all other references were released.  pairs with the release in ~shared_ptr
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        auto top = Value::Helper::store_ptr(prev)->top();
+        {
+            Guard G(top->encoded->lock);
+            top->encoded->entries.clear();
+        }
+        prev.unmark();
+        prev.assign(val);
+
+        // don't keep alive arrays, strings, or compounds of a previous update
+        auto fdesc = desc;
+        auto fstore = Value::Helper::store_ptr(prev);
+        for(size_t i=0u, n=desc->size(); i<n;) {
+            auto& fld = fstore[i];
+            if(fld.valid) {
+                // skip the marked field, and all descendants
+                i += fdesc[i].size();
+                continue;
+            }
+            switch(fld.code) {
+            case StoreType::Array:
+                fld.as<shared_array<const void>>().clear();
+                break;
+            case StoreType::Compound:
+                fld.as<Value>() = Value();
+                break;
+            case StoreType::String:
+                fld.as<std::string>().clear();
+                break;
+            default:
+                break;
+            }
+            i++;
+        }
+        return prev;
+    }
+
+    auto ret(val.clone());
+    shareEncoding(ret);
+    if(spare.size() < limit)
+        spare.push_back(ret);
+    return ret;
+}
+
+void SnapshotPool::trim()
+{
+    spare.erase(std::remove_if(spare.begin(), spare.end(), [](Value& prev) {
+                    return Value::Helper::store(prev).use_count()==1;
+                }), spare.end());
+}
+
+void to_wire_valid(Buffer& buf, const Value& val, const EncodePlan& plan)
+{
+    auto desc = Value::Helper::desc(val);
+    auto store = Value::Helper::store_ptr(val);
+
+    if(desc!=plan.type.get()) {
+        to_wire_valid(buf, val, &plan.mask);
+        return;
+    }
+
+    // desc==plan.type implies a top level Value
+    auto cache = store->top()->encoded.get();
+    if(!cache) {
+        to_wire_planned(buf, desc, store, plan);
+        return;
+    }
+
+    std::vector<EncodeCache::Piece> pieces;
+    {
+        Guard G(cache->lock);
+
+        bool found = false;
+        for(auto& ent : cache->entries) {
+            if(ent.be==buf.be && ent.mask==plan.mask) {
+                pieces = ent.pieces;
+                found = true;
+                break;
+            }
+        }
+
+        if(!found) {
+            {
+                PieceOutBuf S(buf.be, pieces);
+                to_wire_planned(S, desc, store, plan);
+                S.flush();
+                if(!S.good())
+                    throw std::logic_error("Failed to encode shared Value");
+            }
+
+            BitMask mask(plan.mask.size());
+            for(auto bit : plan.mask.onlySet())
+                mask[bit] = true;
+            cache->entries.push_back(EncodeCache::Entry{std::move(mask), buf.be, pieces});
+        }
+    }
+
+    // larger pieces are referenced, which is cheaper than copying
+    constexpr size_t min_reference = 1u<<16u;
+
+    for(auto& piece : pieces) {
+        if(piece.nbytes>=min_reference && buf.reference(piece.bytes, piece.nbytes))
+            continue;
+
+        auto src = static_cast<const uint8_t*>(piece.bytes.data());
+        for(size_t nremain = piece.nbytes; nremain;) {
+            if(buf.empty() && !buf.ensure(1u)) {
+                buf.fault(__FILE__, __LINE__);
+                return;
+            }
+            auto n = std::min(buf.size(), nremain);
+            memcpy(buf.save(), src, n);
+            buf.skip(n, __FILE__, __LINE__);
+            src += n;
+            nremain -= n;
+        }
     }
 }
 
@@ -445,10 +753,129 @@ T from_wire_as(Buffer& buf)
     from_wire(buf, ret);
     return ret;
 }
+
+/* Recently decoded string arrays (eg. enum choices), so that repeated
+ * messages share storage instead of allocating a copy of each string.
+ * Direct mapped by a hash of the serialized bytes.  Elements are immutable.
+ */
+struct StringArrayIntern {
+    static constexpr size_t nslots = 64u;
+    // larger arrays are not interned
+    static constexpr size_t maxBytes = 4096u;
+
+    struct Slot {
+        uint32_t hash = 0u;
+        shared_array<const void> arr;
+    };
+
+    epicsMutex lock;
+    Slot slots[nslots];
+};
+
+StringArrayIntern& stringIntern()
+{
+    static StringArrayIntern* intern = new StringArrayIntern(); // never free'd
+    return *intern;
+}
+
+// FNV-1a
+uint32_t hashBytes(const uint8_t* bytes, size_t len)
+{
+    uint32_t ret = 2166136261u;
+    for(auto i : range(len)) {
+        ret ^= bytes[i];
+        ret *= 16777619u;
+    }
+    return ret;
+}
+
+// does the serialized string array at buf, of nbytes, match arr
+bool sameStrings(bool be, uint8_t* wire, size_t nbytes, const shared_array<const void>& varr)
+{
+    if(varr.original_type()!=ArrayType::String)
+        return false;
+    auto arr(varr.castTo<const std::string>());
+
+    FixedBuf M(be, wire, nbytes);
+    Size alen{};
+    from_wire(M, alen);
+    if(alen.size!=arr.size())
+        return false;
+
+    for(auto& s : arr) {
+        Size slen{};
+        from_wire(M, slen, true);
+        if(slen.size==size_t(-1))
+            slen.size = 0u;
+        if(!M.good() || slen.size!=s.size() || slen.size>M.size() || memcmp(M.save(), s.data(), s.size())!=0)
+            return false;
+        M._skip(slen.size);
+    }
+    return M.good();
+}
+
+// deserialize a string array.  Re-use the current value of fld, or an interned copy, if equal
+void from_wire_strings(Buffer& buf, shared_array<const void>& fld)
+{
+    // find the extent of the serialized array, if completely in the current contiguous slice
+    size_t nbytes = 0u;
+    {
+        FixedBuf M(buf.be, buf.save(), buf.size());
+        Size alen{};
+        from_wire(M, alen);
+        for(size_t i=0u; M.good() && i<alen.size; i++) {
+            Size slen{};
+            from_wire(M, slen, true);
+            if(slen.size!=size_t(-1))
+                M.skip(slen.size, __FILE__, __LINE__);
+        }
+        if(M.good())
+            nbytes = M.save() - buf.save();
+    }
+
+    if(!nbytes || nbytes > StringArrayIntern::maxBytes) {
+        from_wire<std::string>(buf, fld);
+        return;
+    }
+
+    if(sameStrings(buf.be, buf.save(), nbytes, fld)) {
+        buf._skip(nbytes);
+        return;
+    }
+
+    auto& intern = stringIntern();
+    auto hash = hashBytes(buf.save(), nbytes);
+    auto& slot = intern.slots[hash%StringArrayIntern::nslots];
+    {
+        shared_array<const void> prev;
+        {
+            Guard G(intern.lock);
+            if(slot.hash==hash)
+                prev = slot.arr;
+        }
+        if(!prev.empty() && sameStrings(buf.be, buf.save(), nbytes, prev)) {
+            fld = std::move(prev);
+            buf._skip(nbytes);
+            return;
+        }
+    }
+
+    from_wire<std::string>(buf, fld);
+
+    if(buf.good()) {
+        Guard G(intern.lock);
+        slot.hash = hash;
+        slot.arr = fld;
+    }
+}
 }
 
+// deserialize a field and all children (if Compound).
+// 'owner' shares ownership of store->top(), and is only used
+// to reference an enclosing field from a nested Value.
 static
-void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const std::shared_ptr<FieldStorage>& store)
+void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, FieldStorage* store,
+                     const std::shared_ptr<FieldStorage>& owner)
 {
     switch(store->code) {
     case StoreType::Null:
@@ -457,10 +884,10 @@ void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const
             // serialize entire sub-structure
             for(auto off : range(desc->size())) {
                 auto cdesc = desc + off;
-                std::shared_ptr<FieldStorage> cstore(store, store.get()+off); // TODO avoid shared_ptr/aliasing here
+                auto cstore = store + off;
                 if(cdesc->code!=TypeCode::Struct) {
-                    from_wire_field(buf, ctxt, cdesc, cstore);
-                    cstore->valid = true;
+                    from_wire_field(buf, ctxt, cdesc, cstore, owner);
+                    cstore->setValid(true);
                 }
             }
         }
@@ -526,9 +953,9 @@ void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const
                 return;
 
             } else if(select.index() < desc->miter.size()) {
-                std::shared_ptr<const FieldDesc> stype(store->top->desc,
+                std::shared_ptr<const FieldDesc> stype(store->top()->desc,
                                                        &desc->members[desc->miter[select.index()].second]); // alias
-                fld = Value::Helper::build(stype, store, desc);
+                fld = Value::Helper::build(stype, std::shared_ptr<FieldStorage>(owner, store), desc);
 
                 from_wire_full(buf, ctxt, fld);
                 return;
@@ -602,17 +1029,18 @@ void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const
             from_wire<double>(buf, fld);
             return;
         case TypeCode::StringA:
-            from_wire<std::string>(buf, fld);
+            from_wire_strings(buf, fld);
             return;
         case TypeCode::StructA:{
             Size alen{};
             from_wire(buf, alen);
             shared_array<Value> arr(alen.size);
-            std::shared_ptr<const FieldDesc> etype(store->top->desc,
+            std::shared_ptr<const FieldDesc> etype(store->top()->desc,
                                                    &desc->members[0]); // alias
+            std::shared_ptr<FieldStorage> pstore(owner, store); // alias
             for(auto& elem : arr) {
                 if(from_wire_as<uint8_t>(buf)!=0) { // strictly 1 or 0
-                    elem = Value::Helper::build(etype, store, desc);
+                    elem = Value::Helper::build(etype, pstore, desc);
 
                     from_wire_full(buf, ctxt, elem);
                 }
@@ -626,6 +1054,7 @@ void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const
             from_wire(buf, alen);
             shared_array<Value> arr(alen.size);
             auto cdesc = &desc->members[0];
+            std::shared_ptr<FieldStorage> pstore(owner, store); // alias
 
             for(auto& elem : arr) {
                 if(from_wire_as<uint8_t>(buf)!=0) { // strictly 1 or 0
@@ -636,9 +1065,9 @@ void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const
                         // null element.  treated the same as 0 case (which is what actually happens)
 
                     } else if(select.index() < cdesc->miter.size()) {
-                        std::shared_ptr<const FieldDesc> stype(store->top->desc,
+                        std::shared_ptr<const FieldDesc> stype(store->top()->desc,
                                                                &cdesc->members[cdesc->miter[select.index()].second]); // alias
-                        elem = Value::Helper::build(stype, store, desc);
+                        elem = Value::Helper::build(stype, pstore, desc);
 
                         from_wire_full(buf, ctxt, elem);
 
@@ -657,6 +1086,7 @@ void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const
             Size alen{};
             from_wire(buf, alen);
             shared_array<Value> arr(alen.size);
+            std::shared_ptr<FieldStorage> pstore(owner, store); // alias
 
             for(auto& elem : arr) {
                 if(from_wire_as<uint8_t>(buf)!=0) { // strictly 1 or 0
@@ -669,7 +1099,7 @@ void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const
                     if(!descs->empty()) {
 
                         std::shared_ptr<const FieldDesc> stype(descs, descs->data()); // alias
-                        elem = Value::Helper::build(stype, store, desc);
+                        elem = Value::Helper::build(stype, pstore, desc);
 
                         from_wire_full(buf, ctxt, elem);
                     }
@@ -693,20 +1123,21 @@ void from_wire_full(Buffer& buf, TypeStore& ctxt, Value& val)
 {
     assert(!!val);
 
-    from_wire_field(buf, ctxt, Value::Helper::desc(val), Value::Helper::store(val));
+    auto& store = Value::Helper::store(val);
+    from_wire_field(buf, ctxt, Value::Helper::desc(val), store.get(), store);
 }
 
 void from_wire_valid(Buffer& buf, TypeStore& ctxt, Value& val)
 {
     auto desc = Value::Helper::desc(val);
-    auto store = Value::Helper::store(val);
+    auto& store = Value::Helper::store(val);
 
     if(!desc || !store) {
         buf.fault(__FILE__, __LINE__);
         return;
     }
 
-    auto top = store->top;
+    auto top = store->top();
 
     BitMask valid;
     from_wire(buf, valid);
@@ -718,12 +1149,216 @@ void from_wire_valid(Buffer& buf, TypeStore& ctxt, Value& val)
     for(auto bit = valid.findSet(0u);
         bit<desc->size();)
     {
-        std::shared_ptr<FieldStorage> cstore(store, store.get()+bit);
+        auto cstore = store.get() + bit;
+        auto cdesc = desc + bit;
+        from_wire_field(buf, ctxt, cdesc, cstore, store);
+        cstore->setValid(true);
+        bit = valid.findSet(bit + cdesc->size());
+    }
+}
+
+namespace {
+// decode a Size from the start of buf without removing.
+// false if not yet completely received.
+bool peekSize(evbuffer* buf, bool be, bool allow_null, size_t& prefix, size_t& value)
+{
+    uint8_t raw[1u+4u+8u];
+    auto n = evbuffer_copyout(buf, raw, sizeof(raw));
+    if(n<=0)
+        return false;
+
+    FixedBuf M(be, raw, size_t(n));
+    Size sz{0u};
+    from_wire(M, sz, allow_null);
+    if(!M.good())
+        return false;
+
+    prefix = size_t(n) - M.size();
+    value = sz.size;
+    return true;
+}
+} // namespace
+
+void ValidDecoder::setMask(BitMask& valid)
+{
+    auto desc = Value::Helper::desc(val);
+    auto& store = Value::Helper::store(val);
+
+    // encoding rounds # of bits to whole bytes, so we may trim
+    valid.resize(store->top()->members.size());
+
+    for(auto bit = valid.findSet(0u);
+        bit<desc->size();)
+    {
         auto cdesc = desc + bit;
-        from_wire_field(buf, ctxt, cdesc, cstore);
-        cstore->valid = true;
+        nodes.push_back(bit);
+        if(cdesc->code==TypeCode::Struct) {
+            for(auto off : range(cdesc->size())) {
+                if(cdesc[off].code!=TypeCode::Struct)
+                    leaves.push_back(bit + off);
+            }
+        } else {
+            leaves.push_back(bit);
+        }
         bit = valid.findSet(bit + cdesc->size());
     }
+    haveMask = true;
+}
+
+void ValidDecoder::finishArray()
+{
+    auto cstore = Value::Helper::store_ptr(val) + leaves[nextLeaf];
+    cstore->as<shared_array<const void>>() = arr.freeze();
+    cstore->setValid(true);
+    arrDone = 0u;
+    inArray = false;
+    nextLeaf++;
+}
+
+void ValidDecoder::partial(evbuffer* buf, bool be, TypeStore& ctxt)
+{
+    auto desc = Value::Helper::desc(val);
+    auto& store = Value::Helper::store(val);
+
+    if(failed || !desc || !store)
+        return;
+
+    if(!haveMask) {
+        size_t prefix=0u, nbytes=0u;
+        if(!peekSize(buf, be, false, prefix, nbytes) || evbuffer_get_length(buf) < prefix + nbytes)
+            return;
+
+        EvInBuf M(be, buf);
+        BitMask valid;
+        from_wire(M, valid);
+        if(!M.good()) {
+            failed = true;
+            return;
+        }
+        setMask(valid);
+    }
+
+    while(nextLeaf < leaves.size()) {
+        auto cdesc = desc + leaves[nextLeaf];
+        auto cstore = store.get() + leaves[nextLeaf];
+        auto kind = cdesc->code.kind();
+        bool numeric = kind==Kind::Bool || kind==Kind::Integer || kind==Kind::Real;
+
+        if(numeric && cdesc->code.isarray()) {
+            if(!inArray) {
+                size_t prefix=0u, count=0u;
+                if(!peekSize(buf, be, false, prefix, count))
+                    return;
+                evbuffer_drain(buf, prefix);
+                arr = allocArray(cdesc->code.arrayType(), count);
+                arrDone = 0u;
+                inArray = true;
+            }
+
+            auto esize = elementSize(arr.original_type());
+            auto dest = static_cast<char*>(arr.data()) + arrDone;
+            // whole elements only
+            auto n = std::min(evbuffer_get_length(buf), arr.size()*esize - arrDone)/esize*esize;
+
+            if(n) {
+                EvInBuf M(be, buf);
+                if(!M.copyOut(dest, n)) {
+                    failed = true;
+                    return;
+                }
+                if(esize>1u && be!=hostBE)
+                    copySwapped(dest, dest, n/esize, esize);
+                arrDone += n;
+            }
+
+            if(arrDone < arr.size()*esize)
+                return; // more to come
+
+            finishArray();
+            continue;
+        }
+
+        size_t need;
+        if(numeric) {
+            need = cdesc->code.size();
+
+        } else if(cdesc->code==TypeCode::String) {
+            size_t prefix=0u, len=0u;
+            if(!peekSize(buf, be, true, prefix, len))
+                return;
+            need = prefix + len;
+
+        } else {
+            return; // variable length.  wait for finish()
+        }
+
+        if(evbuffer_get_length(buf) < need)
+            return;
+
+        EvInBuf M(be, buf);
+        from_wire_field(M, ctxt, cdesc, cstore, store);
+        if(!M.good()) {
+            failed = true;
+            return;
+        }
+        cstore->setValid(true);
+        nextLeaf++;
+    }
+}
+
+void ValidDecoder::finish(Buffer& buf, TypeStore& ctxt)
+{
+    auto desc = Value::Helper::desc(val);
+    auto& store = Value::Helper::store(val);
+
+    if(failed || !desc || !store) {
+        buf.fault(__FILE__, __LINE__);
+        return;
+    }
+
+    if(!haveMask) {
+        BitMask valid;
+        from_wire(buf, valid);
+        if(!buf.good())
+            return;
+        setMask(valid);
+    }
+
+    if(inArray) {
+        // complete a partially filled array
+        auto esize = elementSize(arr.original_type());
+        auto dest = static_cast<char*>(arr.data()) + arrDone;
+
+        for(size_t nremain = arr.size()*esize - arrDone; nremain;) {
+            if(!buf.ensure(esize)) {
+                buf.fault(__FILE__, __LINE__);
+                return;
+            }
+
+            size_t nbytes = std::min(buf.size(), nremain)/esize*esize;
+
+            if(esize>1u && buf.be!=hostBE)
+                copySwapped(dest, buf.save(), nbytes/esize, esize);
+            else
+                memcpy(dest, buf.save(), nbytes);
+
+            dest += nbytes;
+            buf.skip(nbytes, __FILE__, __LINE__);
+            nremain -= nbytes;
+        }
+
+        finishArray();
+    }
+
+    for(; nextLeaf < leaves.size(); nextLeaf++) {
+        auto cstore = store.get() + leaves[nextLeaf];
+        from_wire_field(buf, ctxt, desc + leaves[nextLeaf], cstore, store);
+        cstore->setValid(true);
+    }
+
+    for(auto bit : nodes) {
+        store.get()[bit].setValid(true);
+    }
 }
 
 void from_wire_type(Buffer& buf, TypeStore& ctxt, Value& val)
@@ -247,7 +247,7 @@ struct FmtTree {
                 //def = fld.allocMember(); // can't call directly due to const
                 auto desc(Value::Helper::desc(fld));
                 auto store(Value::Helper::store(fld));
-                decltype (store->top->desc) fld(store->top->desc, desc->members.data());
+                decltype (store->top()->desc) fld(store->top()->desc, desc->members.data());
                 def = Value::Helper::build(fld); // not connection to fld (not parent)
             }
 
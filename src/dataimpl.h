@@ -9,11 +9,15 @@
 #include <string>
 #include <map>
 
+#include <epicsMutex.h>
+
 #include <pvxs/data.h>
 #include <pvxs/sharedArray.h>
 #include "bitmask.h"
 #include "utilpvt.h"
 
+struct evbuffer;
+
 namespace pvxs {
 
 struct Value::Helper {
@@ -53,6 +57,33 @@ void cache_sync(Value& cache, Value& delta);
 namespace impl {
 struct Buffer;
 
+/** Mapping from field name, or path, to relative index.
+ *
+ * A flat table sorted by name, for lexical iteration,
+ * with an open addressed hash index for find().
+ */
+class PVXS_API FieldLookup {
+public:
+    typedef std::pair<std::string, size_t> value_type;
+    typedef std::vector<value_type>::const_iterator const_iterator;
+
+    //! Replace contents.  For duplicate names, the last entry is kept.
+    void build(std::vector<value_type>&& entries);
+
+    const_iterator find(const char* name, size_t len) const;
+    inline const_iterator find(const std::string& name) const { return find(name.data(), name.size()); }
+
+    inline const_iterator begin() const { return entries.begin(); }
+    inline const_iterator end() const { return entries.end(); }
+    inline size_t size() const { return entries.size(); }
+    inline bool empty() const { return entries.empty(); }
+
+private:
+    std::vector<value_type> entries;
+    // index in entries plus one, or zero if unused.  size() is a power of 2
+    std::vector<uint32_t> slots;
+};
+
 /** Describes a single field, leaf or otherwise, in a nested structure.
  *
  * FieldDesc are always stored depth first as a contiguous array,
@@ -70,7 +101,7 @@ struct FieldDesc {
     // "fld.sub.leaf" -> rel index
     // For Struct, relative to this (always >=1)
     // For Union, offset in members array (one entry will always be zero)
-    std::map<std::string, size_t> mlookup;
+    FieldLookup mlookup;
 
     // child iteration.  child# -> ("sub", rel index in enclosing vector<FieldDesc>)
     std::vector<std::pair<std::string, size_t>> miter;
@@ -89,6 +120,10 @@ struct FieldDesc {
 
     explicit FieldDesc(TypeCode code) :code{code} {}
 
+    // populate mlookup from miter, and the mlookup of any sub-structures.
+    // For Struct, requires that all descendants follow this.
+    void buildLookup();
+
     // number of FieldDesc nodes which describe this node.  Inclusive.  always size()>=1
     inline size_t size() const { return 1u + (members.empty() ? mlookup.size() : 0u); }
 };
@@ -103,6 +138,16 @@ void from_wire(Buffer& buf, std::vector<FieldDesc>& descs, TypeStore& cache, uns
 
 struct StructTop;
 
+// Is T held out of line by FieldStorage
+template<typename T>
+struct OutOfLine : std::false_type {};
+#ifdef PVXS_COMPACT_STORAGE
+template<> struct OutOfLine<std::string> : std::true_type {};
+template<> struct OutOfLine<Value> : std::true_type {};
+template<> struct OutOfLine<shared_array<const void>> : std::true_type {};
+template<> struct OutOfLine<shared_array<void>> : std::true_type {};
+#endif
+
 struct FieldStorage {
     /* Storage for field value.  depends on StoreType.
      *
@@ -112,7 +157,18 @@ struct FieldStorage {
      * Reals promoted to double.
      * String stored as std::string
      * Compound (Struct, Union, Any) stored as Value
+     *
+     * With PVXS_COMPACT_STORAGE, String, Compound, and Array are allocated
+     * separately, and store holds only a pointer.  Halves the size of FieldStorage,
+     * at the cost of one more allocation for each such field.
      */
+#ifdef PVXS_COMPACT_STORAGE
+    aligned_union<8,
+                       double, // Real
+                       uint64_t, // Bool, Integer
+                       void* // String, Compound, Array
+    >::type store;
+#else
     aligned_union<8,
                        double, // Real
                        uint64_t, // Bool, Integer
@@ -120,8 +176,10 @@ struct FieldStorage {
                        Value, // Union, Any
                        shared_array<const void> // array of POD, std::string, or std::shared_ptr<Value>
     >::type store;
+#endif
     // index of this field in StructTop::members
-    StructTop *top;
+    uint32_t idx=0u;
+    // marked.  Change only through setValid()
     bool valid=false;
     StoreType code=StoreType::Null;
 
@@ -132,31 +190,137 @@ struct FieldStorage {
     FieldStorage& operator=(const FieldStorage&) = delete;
     ~FieldStorage();
 
-    size_t index() const;
+    inline size_t index() const { return idx; }
+    // the StructTop which holds this field
+    inline StructTop* top() const;
+    // set valid, and the corresponding bit of FieldArray::validWords()
+    inline void setValid(bool v);
 
     template<typename T>
-    T& as() { return *reinterpret_cast<T*>(&store); }
+    typename std::enable_if<!OutOfLine<T>::value, T&>::type
+    as() { return *reinterpret_cast<T*>(&store); }
+    template<typename T>
+    typename std::enable_if<!OutOfLine<T>::value, const T&>::type
+    as() const { return *reinterpret_cast<const T*>(&store); }
     template<typename T>
-    const T& as() const { return *reinterpret_cast<const T*>(&store); }
+    typename std::enable_if<OutOfLine<T>::value, T&>::type
+    as() { return **reinterpret_cast<T**>(&store); }
+    template<typename T>
+    typename std::enable_if<OutOfLine<T>::value, const T&>::type
+    as() const { return **reinterpret_cast<T* const*>(&store); }
+
+    // address of the value, in the form expected by Value::copyIn()
+    const void* addr() const {
+        switch(code) {
+        case StoreType::String: return &as<std::string>();
+        case StoreType::Compound: return &as<Value>();
+        case StoreType::Array: return &as<shared_array<const void>>();
+        default: return &store;
+        }
+    }
 
     inline uint8_t* buffer() { return reinterpret_cast<uint8_t*>(&store); }
     inline const uint8_t* buffer() const { return reinterpret_cast<const uint8_t*>(&store); }
 };
 
+/* The FieldStorage of a StructTop.  A fixed size array, preceded by a pointer
+ * back to the StructTop, so that each FieldStorage need only hold its index.
+ * Followed by a dense copy of the FieldStorage::valid flags, one bit per field,
+ * so that marked fields can be found a word at a time.
+ */
+class FieldArray {
+    struct Header {
+        StructTop* top;
+        size_t count;
+    };
+    static_assert(sizeof(Header)%alignof(FieldStorage)==0, "FieldStorage must follow Header");
+
+    FieldStorage* first;
+
+    const Header& header() const { return reinterpret_cast<const Header*>(first)[-1]; }
+public:
+    FieldArray(StructTop* top, size_t count);
+    ~FieldArray();
+    FieldArray(const FieldArray&) = delete;
+    FieldArray& operator=(const FieldArray&) = delete;
+
+    inline size_t size() const { return header().count; }
+    inline FieldStorage* data() const { return first; }
+    inline FieldStorage* begin() const { return first; }
+    inline FieldStorage* end() const { return first + size(); }
+    inline FieldStorage& operator[](size_t i) const { return first[i]; }
+    FieldStorage& at(size_t i) const {
+        if(i>=size())
+            throw std::out_of_range("FieldArray index");
+        return first[i];
+    }
+
+    //! number of words in validWords()
+    static inline size_t nwords(size_t count) { return (count+63u)/64u; }
+    inline uint64_t* validWords() const { return validWordsOf(first); }
+
+    static inline StructTop* topOf(const FieldStorage* first) {
+        return reinterpret_cast<const Header*>(first)[-1].top;
+    }
+    static inline uint64_t* validWordsOf(const FieldStorage* first) {
+        auto count = reinterpret_cast<const Header*>(first)[-1].count;
+        return reinterpret_cast<uint64_t*>(const_cast<FieldStorage*>(first + count));
+    }
+};
+
+StructTop* FieldStorage::top() const
+{
+    return FieldArray::topOf(this - idx);
+}
+
+void FieldStorage::setValid(bool v)
+{
+    valid = v;
+    auto& word = FieldArray::validWordsOf(this - idx)[idx/64u];
+    auto bit = uint64_t(1u)<<(idx%64u);
+    if(v)
+        word |= bit;
+    else
+        word &= ~bit;
+}
+
+/** Serializations of a Value which will not be modified again.
+ *
+ * Allows several subscribers to share a single encoding of an update.
+ * Entries are keyed by mask and byte order.
+ */
+struct EncodeCache {
+    // a run of encoded bytes, or a referenced array
+    struct Piece {
+        shared_array<const void> bytes;
+        size_t nbytes;
+    };
+    struct Entry {
+        BitMask mask;
+        bool be;
+        std::vector<Piece> pieces;
+    };
+    epicsMutex lock;
+    std::vector<Entry> entries;
+};
+
 // hidden (publicly) management of an allocated Struct
 struct StructTop {
     // type of first top level struct.  always !NULL.
     // Actually the first element of a vector<const FieldDesc>
     std::shared_ptr<const FieldDesc> desc;
     // our members (inclusive).  always size()>=1
-    std::vector<FieldStorage> members;
+    FieldArray members;
 
     // empty, or the field of a structure which encloses this.
     std::weak_ptr<FieldStorage> enclosing;
 
+    // non-NULL after shareEncoding()
+    std::unique_ptr<EncodeCache> encoded;
+
     StructTop(const std::shared_ptr<const FieldDesc>& desc)
         :desc(desc)
-        ,members(desc->size())
+        ,members(this, desc->size())
     {}
 
     INST_COUNTER(StructTop);
@@ -164,6 +328,10 @@ struct StructTop {
 
 using Type = std::shared_ptr<const FieldDesc>;
 
+//! Gather the valid flags of nfields consecutive FieldStorage into mask.
+//! mask is resized to nfields.
+PVXS_API
+void collectValid(BitMask& mask, const FieldStorage* store, size_t nfields);
 
 //! serialize all Value fields
 PVXS_API
@@ -173,6 +341,114 @@ void to_wire_full(Buffer& buf, const Value& val);
 PVXS_API
 void to_wire_valid(Buffer& buf, const Value& val, const BitMask* mask=nullptr);
 
+/** Pre-computed equivalent of to_wire_valid() for one Struct type and mask.
+ *
+ * Built once, eg. when an operation is connected, then used for each update.
+ */
+struct PVXS_API EncodePlan {
+    typedef void (*encoder_t)(Buffer& buf, const FieldDesc* desc, const FieldStorage* store);
+
+    // serialize a single non-Struct field
+    struct Op {
+        size_t index; // in type
+        encoder_t fn;
+    };
+    // a field included by mask
+    struct Step {
+        size_t index; // in type
+        size_t next; // in steps.  skips past children
+        size_t opBegin, opEnd; // in ops.  serializes this field and children
+    };
+
+    Type type;
+    BitMask mask;
+    std::vector<Step> steps;
+    std::vector<Op> ops;
+
+    EncodePlan() = default;
+    EncodePlan(const Type& type, BitMask&& mask);
+};
+
+//! serialize BitMask and marked valid Value fields according to a plan.
+//! Equivalent to to_wire_valid(buf, val, &plan.mask)
+PVXS_API
+void to_wire_valid(Buffer& buf, const Value& val, const EncodePlan& plan);
+
+/** Promise that the top level Value val will not be modified.
+ *
+ * Subsequent calls to to_wire_valid() with an EncodePlan then
+ * encode once for each mask and byte order, and copy or reference that encoding.
+ */
+PVXS_API
+void shareEncoding(const Value& val);
+
+//! Has shareEncoding() been called for this Value
+PVXS_API
+bool isEncodingShared(const Value& val);
+
+/** Re-usable copies of updates, eg. to be queued for several subscribers.
+ *
+ * A copy is re-used once all other references to it have been released.
+ * So a steady stream of updates with the same type need not allocate.
+ */
+struct PVXS_API SnapshotPool {
+    explicit SnapshotPool(size_t limit=8u) :limit(limit) {}
+
+    /** Equivalent to val.clone() followed by shareEncoding().
+     *
+     * Only fields marked in val are meaningful in the result.
+     * Unmarked scalar fields have unspecified values.  Unmarked
+     * string, array, and compound fields are empty.
+     */
+    Value snapshot(const Value& val);
+    //! Release all copies
+    void clear() { spare.clear(); }
+    //! Release copies which are not referenced elsewhere
+    void trim();
+
+private:
+    size_t limit;
+    std::vector<Value> spare;
+};
+
+/** Re-usable storage for Values of one type.
+ *
+ * Each StructTop, with its members, and the shared_ptr control block
+ * which owns it, is returned to the pool when the last reference to a Value
+ * created by the pool is released.  So in steady state create() does not allocate.
+ *
+ * Must be owned by a std::shared_ptr.  Created Values keep the pool alive.
+ */
+struct PVXS_API StructPool final : public std::enable_shared_from_this<StructPool> {
+    //! @pre prototype.valid()
+    StructPool(const Value& prototype, size_t limit);
+    ~StructPool();
+
+    //! Equivalent to prototype.cloneEmpty()
+    Value create();
+
+    //! Number of StructTop waiting for re-use
+    size_t nfree() const;
+
+private:
+    template<typename T>
+    friend struct StructPoolAlloc;
+    friend struct StructPoolRelease;
+
+    const std::shared_ptr<const FieldDesc> type;
+    const size_t limit;
+
+    mutable epicsMutex lock;
+    std::vector<StructTop*> tops;
+    // memory for shared_ptr control blocks.  all of blockSize
+    std::vector<void*> blocks;
+    size_t blockSize = 0u;
+
+    void* allocBlock(size_t nbytes);
+    void freeBlock(void* block, size_t nbytes);
+    void release(StructTop* top);
+};
+
 //! deserialize type description
 PVXS_API
 void from_wire_type(Buffer& buf, TypeStore& ctxt, Value& val);
@@ -185,6 +461,36 @@ void from_wire_full(Buffer& buf, TypeStore& ctxt, Value& val);
 PVXS_API
 void from_wire_valid(Buffer& buf, TypeStore& ctxt, Value& val);
 
+/** Equivalent to from_wire_valid(), which may begin before all bytes are received.
+ *
+ * eg. while the segments of a long message arrive.
+ */
+struct PVXS_API ValidDecoder {
+    Value val;
+
+    explicit ValidDecoder(Value&& val) :val(std::move(val)) {}
+
+    //! Decode, and remove from buf, any leading fields which have been completely received.
+    //! Elements of a numeric array are copied as they arrive.
+    //! Stops before a field which is incomplete, or not fixed size (eg. Union).
+    void partial(evbuffer* buf, bool be, TypeStore& ctxt);
+    //! Decode the remaining fields, which must all be available from buf.
+    void finish(Buffer& buf, TypeStore& ctxt);
+
+private:
+    bool haveMask = false;
+    bool failed = false;
+    std::vector<size_t> leaves; // non-Struct fields to decode, in order
+    std::vector<size_t> nodes;  // fields to mark valid when complete
+    size_t nextLeaf = 0u;
+    bool inArray = false;       // filling arr for leaves[nextLeaf]
+    shared_array<void> arr;
+    size_t arrDone = 0u;        // bytes of arr already filled
+
+    void setMask(BitMask& valid);
+    void finishArray();
+};
+
 //! deserialize type description and full value (a la. pvRequest)
 PVXS_API
 void from_wire_type_value(Buffer& buf, TypeStore& ctxt, Value& val);
@@ -199,7 +505,7 @@ Value Value::Helper::build(const std::shared_ptr<const impl::FieldDesc>& desc,
                            const std::shared_ptr<impl::FieldStorage>& pstore, const impl::FieldDesc* pdesc)
 {
     Value ret(desc);
-    auto& enc = ret.store->top->enclosing;
+    auto& enc = ret.store->top()->enclosing;
     enc = pstore;
     return ret;
 }
@@ -13,7 +13,8 @@
 
 #include <cstring>
 #include <system_error>
-#include <deque>
+#include <atomic>
+#include <map>
 #include <limits>
 #include <algorithm>
 
@@ -121,13 +122,35 @@ struct evbase::Pvt final : public epicsThreadRunable
 
     struct Work {
         mfunction fn;
-        std::exception_ptr *result;
-        epicsEvent *notify;
+        std::exception_ptr *result = nullptr;
+        epicsEvent *notify = nullptr;
+        Work() = default;
         Work(mfunction&& fn, std::exception_ptr *result, epicsEvent *notify)
             :fn(std::move(fn)), result(result), notify(notify)
         {}
     };
-    std::deque<Work> actions;
+
+    /* Pending work is a bounded multi-producer, single consumer ring.
+     * Each producer claims a ticket from 'tail'.  If the slot for
+     * this ticket is free, the Work is stored there and published through
+     * Slot::seq.  If the ring is full, the Work is stored in 'overflow'.
+     * The worker runs tickets strictly in order, so dispatch() remains FIFO.
+     */
+    struct Slot {
+        // ticket+1 once 'work' is filled in
+        std::atomic<size_t> seq;
+        Work work;
+    };
+    static constexpr size_t nSlots = 1024u; // must be a power of 2
+    const std::unique_ptr<Slot[]> slots;
+    // next ticket to claim
+    std::atomic<size_t> tail{0u};
+    // next ticket to run.  Only written by worker
+    std::atomic<size_t> head{0u};
+    // true while a dowork event is pending
+    std::atomic<bool> wakeup{false};
+    // guarded by lock
+    std::map<size_t, Work> overflow;
 
     evbaseptr base;
     evevent keepalive;
@@ -136,17 +159,23 @@ struct evbase::Pvt final : public epicsThreadRunable
     epicsMutex lock;
 
     epicsThread worker;
-    bool running = true;
+    std::atomic<bool> running{true};
 
     INST_COUNTER(evbase);
 
     Pvt(const std::string& name, unsigned prio)
-        :worker(*this, name.c_str(),
+        :slots(new Slot[nSlots])
+        ,worker(*this, name.c_str(),
                 epicsThreadGetStackSize(epicsThreadStackBig),
                 prio)
     {
         threadOnce<&evthread_init>();
 
+        for(auto i : range(nSlots)) {
+            // as if ticket i-nSlots has been run
+            slots[i].seq.store(i + 1u - nSlots, std::memory_order_relaxed);
+        }
+
         worker.start();
         start_sync.wait();
         if(!base) {
@@ -158,10 +187,7 @@ struct evbase::Pvt final : public epicsThreadRunable
 
     void join()
     {
-        {
-            Guard G(lock);
-            running = false;
-        }
+        running = false;
         if(worker.isCurrentThread())
             log_crit_printf(logerr, "evbase self-joining: %s\n", worker.getNameSelf());
         if(event_base_loopexit(base.get(), nullptr))
@@ -216,20 +242,67 @@ struct evbase::Pvt final : public epicsThreadRunable
         }
     }
 
-    void doWork()
+    // queue Work for 'n' functions with consecutive tickets.  Wakeup worker if necessary.
+    void enqueue(mfunction* fns, size_t n, std::exception_ptr *result, epicsEvent *notify)
     {
-        decltype (actions) todo;
-        {
-            Guard G(lock);
-            todo = std::move(actions);
+        const auto first = tail.fetch_add(n);
+
+        for(auto i : range(n)) {
+            const auto ticket = first + i;
+
+            if(ticket - head.load(std::memory_order_acquire) < nSlots) {
+                // worker has finished with ticket-nSlots, so this slot is ours
+                auto& slot = slots[ticket & (nSlots-1u)];
+                slot.work = Work(std::move(fns[i]), result, notify);
+                slot.seq.store(ticket + 1u, std::memory_order_release);
+
+            } else {
+                Guard G(lock);
+                overflow.emplace(std::piecewise_construct,
+                                 std::forward_as_tuple(ticket),
+                                 std::forward_as_tuple(std::move(fns[i]), result, notify));
+            }
         }
-        for(auto& work : todo) {
+
+        if(!wakeup.exchange(true)) {
+            timeval now{};
+            if(event_add(dowork.get(), &now))
+                throw std::runtime_error("Unable to wakeup dispatch()");
+        }
+    }
+
+    void doWork()
+    {
+        // any producer which has not finished with a ticket by now will wake us again
+        (void)wakeup.exchange(false);
+
+        // only run what is already queued.  Work queued from this loop will run on the next wakeup.
+        const auto end = tail.load();
+        auto next = head.load(std::memory_order_relaxed);
+
+        while(next!=end) {
+            Work work;
+
+            auto& slot = slots[next & (nSlots-1u)];
+            if(slot.seq.load(std::memory_order_acquire)==next+1u) {
+                work = std::move(slot.work);
+
+            } else {
+                Guard G(lock);
+                auto it = overflow.find(next);
+                if(it==overflow.end())
+                    break; // producer has not finished storing this ticket
+                work = std::move(it->second);
+                overflow.erase(it);
+            }
+
+            head.store(++next, std::memory_order_release);
+
             try {
                 auto fn(std::move(work.fn));
                 fn();
             }catch(std::exception& e){
                 if(work.result) {
-                    Guard G(lock);
                     *work.result = std::current_exception();
                 } else {
                     log_exc_printf(logerr, "Unhandled exception in event_base : %s : %s\n",
@@ -294,23 +367,16 @@ void evbase::sync() const
     call([](){});
 }
 
-bool evbase::_dispatch(mfunction&& fn, bool dothrow) const
+bool evbase::_dispatch(mfunction* fns, size_t n, bool dothrow) const
 {
-    bool empty;
-    {
-        Guard G(pvt->lock);
-        if(!pvt->running) {
-            if(dothrow)
-                throw std::logic_error("Worker stopped");
-            return false;
-        }
-        empty = pvt->actions.empty();
-        pvt->actions.emplace_back(std::move(fn), nullptr, nullptr);
+    if(!pvt->running) {
+        if(dothrow)
+            throw std::logic_error("Worker stopped");
+        return false;
     }
 
-    timeval now{};
-    if(empty && event_add(pvt->dowork.get(), &now))
-        throw std::runtime_error("Unable to wakeup dispatch()");
+    if(n)
+        pvt->enqueue(fns, n, nullptr, nullptr);
 
     return true;
 }
@@ -324,25 +390,17 @@ bool evbase::_call(mfunction&& fn, bool dothrow) const
 
     static ThreadEvent done;
 
-    std::exception_ptr result;
-    bool empty;
-    {
-        Guard G(pvt->lock);
-        if(!pvt->running) {
-            if(dothrow)
-                throw std::logic_error("Worker stopped");
-            return false;
-        }
-        empty = pvt->actions.empty();
-        pvt->actions.emplace_back(std::move(fn), &result, done.get());
+    if(!pvt->running) {
+        if(dothrow)
+            throw std::logic_error("Worker stopped");
+        return false;
     }
 
-    timeval now{};
-    if(empty && event_add(pvt->dowork.get(), &now))
-        throw std::runtime_error("Unable to wakeup call()");
+    std::exception_ptr result;
+    pvt->enqueue(&fn, 1u, &result, done.get());
 
     done->wait();
-    Guard G(pvt->lock);
+    // result written before notify
     if(result)
         std::rethrow_exception(result);
     return true;
@@ -363,7 +421,6 @@ bool evbase::assertInRunningLoop() const
     if(pvt->worker.isCurrentThread())
         return true;
 
-    Guard G(pvt->lock);
     if(!pvt->running)
         return false;
 
@@ -936,6 +993,10 @@ void from_wire(Buffer &buf, SockAddr& val)
 
 bool Buffer::refill(size_t more) { return false; }
 
+bool Buffer::reference(const shared_array<const void>& arr, size_t nbytes) { return false; }
+
+bool Buffer::copyOut(void* dest, size_t nbytes) { return false; }
+
 FixedBuf::~FixedBuf() {}
 
 VectorOutBuf::~VectorOutBuf() {}
@@ -985,6 +1046,28 @@ bool EvOutBuf::refill(size_t more)
     return true;
 }
 
+static
+void releaseReference(const void *data, size_t datalen, void *extra)
+{
+    delete static_cast<shared_array<const void>*>(extra);
+}
+
+bool EvOutBuf::reference(const shared_array<const void>& arr, size_t nbytes)
+{
+    // commit anything already written, so that ordering is preserved
+    if(err || !refill(0))
+        return false;
+
+    // keeps storage alive until the evbuffer chain is drained, eg. sent
+    std::unique_ptr<shared_array<const void>> ref(new shared_array<const void>(arr));
+
+    if(evbuffer_add_reference(backing, arr.data(), nbytes, &releaseReference, ref.get()))
+        return false;
+
+    ref.release(); // now owned by backing
+    return true;
+}
+
 EvInBuf::~EvInBuf() { refill(0); }
 
 bool EvInBuf::refill(size_t needed)
@@ -1035,6 +1118,33 @@ bool EvInBuf::refill(size_t needed)
     return true;
 }
 
+bool EvInBuf::copyOut(void* dest, size_t nbytes)
+{
+    if(err)
+        return false;
+
+    // drain consumed
+    if(base && evbuffer_drain(backing, pos-base))
+        throw BAD_ALLOC();
+
+    limit = base = pos = nullptr;
+
+    if(evbuffer_get_length(backing) < nbytes)
+        return false;
+
+    // evbuffer_remove() returns int
+    constexpr size_t max_chunk = 1u<<30u;
+
+    for(auto cur = static_cast<char*>(dest); nbytes;) {
+        auto n = std::min(nbytes, max_chunk);
+        if(evbuffer_remove(backing, cur, n)!=int(n))
+            throw std::logic_error("evbuffer_remove() short");
+        cur += n;
+        nbytes -= n;
+    }
+    return true;
+}
+
 void to_evbuf(evbuffer *buf, const Header& H, bool be)
 {
     EvOutBuf M(be, buf, 8);
@@ -1043,6 +1153,73 @@ void to_evbuf(evbuffer *buf, const Header& H, bool be)
         throw BAD_ALLOC();
 }
 
+size_t to_evbuf(evbuffer *buf, Header H, evbuffer *body, bool be, size_t maxSegment)
+{
+    // segment length must fit in Header::len, and evbuffer_remove_buffer() returns int
+    constexpr size_t maxLen = size_t(std::numeric_limits<int>::max());
+    maxSegment = std::min(maxSegment, maxLen);
+    assert(maxSegment>0u);
+
+    auto remaining = evbuffer_get_length(body);
+    H.flags &= ~pva_flags::SegMask;
+
+    if(remaining<=maxSegment) { // common case.  no segmentation
+        H.len = uint32_t(remaining);
+        to_evbuf(buf, H, be);
+        auto err = evbuffer_add_buffer(buf, body);
+        assert(!err); // could only fail if frozen/pinned, which is not the case
+        return 8u + remaining;
+    }
+
+    /* Segment boundaries are placed between evbuffer chains where possible.
+     * evbuffer_remove_buffer() then moves chains instead of copying.
+     * A single chain longer than maxSegment, eg. an array added by
+     * reference, is sent as one segment.
+     */
+    std::vector<evbuffer_iovec> chains(evbuffer_peek(body, -1, nullptr, nullptr, 0));
+    chains.resize(evbuffer_peek(body, -1, nullptr, chains.data(), chains.size()));
+
+    size_t ntx = 0u;
+    auto chain = chains.begin();
+    size_t chainUsed = 0u; // of *chain, if split
+    for(bool first = true; remaining; first = false) {
+        size_t n = 0u;
+        for(; chain!=chains.end(); ++chain, chainUsed = 0u) {
+            auto clen = chain->iov_len - chainUsed;
+            if(n + clen <= maxSegment) {
+                n += clen;
+
+            } else if(n==0u) { // long chain
+                n = std::min(clen, maxLen);
+                chainUsed += n;
+                if(chainUsed < chain->iov_len)
+                    break; // remainder of this chain in next segment
+            } else {
+                break;
+            }
+        }
+        if(chain==chains.end())
+            n = remaining; // paranoia.  chains should sum to remaining
+        bool last = n==remaining;
+
+        H.flags &= ~pva_flags::SegMask;
+        if(!last)
+            H.flags |= first ? pva_flags::SegFirst : pva_flags::SegMask; // first or middle
+        else if(!first)
+            H.flags |= pva_flags::SegLast;
+        // else one long chain, so no segmentation after all
+        H.len = uint32_t(n);
+
+        to_evbuf(buf, H, be);
+        if(evbuffer_remove_buffer(body, buf, n)!=int(n))
+            throw BAD_ALLOC();
+
+        remaining -= n;
+        ntx += 8u + n;
+    }
+    return ntx;
+}
+
 } // namespace impl
 
 std::atomic<size_t> Timer::Pvt::cnt_Timer {0u};
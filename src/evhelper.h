@@ -167,7 +167,7 @@ struct PVXS_API evbase {
     void sync() const;
 
 private:
-    bool _dispatch(mfunction&& fn, bool dothrow) const;
+    bool _dispatch(mfunction* fns, size_t n, bool dothrow) const;
     bool _call(mfunction&& fn, bool dothrow) const;
 public:
 
@@ -184,11 +184,22 @@ public:
     // queue request to execute in event loop.  return immediately.
     inline
     void dispatch(mfunction&& fn) const {
-        _dispatch(std::move(fn), true);
+        _dispatch(&fn, 1u, true);
     }
     inline
     bool tryDispatch(mfunction&& fn) const {
-        return _dispatch(std::move(fn), false);
+        return _dispatch(&fn, 1u, false);
+    }
+
+    // queue several requests to execute in event loop, in order, with a single wakeup.
+    // return immediately.
+    inline
+    void dispatch(std::vector<mfunction>&& fns) const {
+        _dispatch(fns.data(), fns.size(), true);
+    }
+    inline
+    bool tryDispatch(std::vector<mfunction>&& fns) const {
+        return _dispatch(fns.data(), fns.size(), false);
     }
 
     bool tryInvoke(bool docall, mfunction&& fn) const {
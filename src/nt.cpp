@@ -193,6 +193,119 @@ Value NTTable::create() const
     return ret;
 }
 
+namespace detail {
+TableColumnBase::~TableColumnBase() {}
+} // namespace detail
+
+namespace {
+std::unique_ptr<detail::TableColumnBase> makeColumn(ArrayType type)
+{
+    std::unique_ptr<detail::TableColumnBase> ret;
+    switch(type) {
+#define CASE(TYPE, CODE) case ArrayType::CODE: ret.reset(new detail::TableColumn<TYPE>()); break
+    CASE(bool, Bool);
+    CASE(int8_t,  Int8);
+    CASE(int16_t, Int16);
+    CASE(int32_t, Int32);
+    CASE(int64_t, Int64);
+    CASE(uint8_t,  UInt8);
+    CASE(uint16_t, UInt16);
+    CASE(uint32_t, UInt32);
+    CASE(uint64_t, UInt64);
+    CASE(float, Float32);
+    CASE(double, Float64);
+    CASE(std::string, String);
+#undef CASE
+    default:
+        break;
+    }
+    return ret;
+}
+} // namespace
+
+TableBuilder::TableBuilder(const Value& prototype)
+    :prototype(prototype)
+{
+    auto value(prototype["value"]);
+    if(value.type()!=TypeCode::Struct)
+        throw std::logic_error("TableBuilder prototype must have a \"value\" sub-structure");
+
+    for(auto fld : value.ichildren()) {
+        const auto& name = value.nameOf(fld);
+        auto code(fld.type());
+        std::unique_ptr<detail::TableColumnBase> col;
+        if(code.isarray())
+            col = makeColumn(ArrayType(code.code));
+        if(!col)
+            throw std::logic_error(SB()<<"TableBuilder column "<<name<<" must be a scalar array, not "<<code);
+
+        names.push_back(name);
+        fields.push_back(prototype.handle("value."+name));
+        cols.push_back(std::move(col));
+    }
+}
+
+TableBuilder::~TableBuilder() {}
+
+detail::TableColumnBase* TableBuilder::_column(const std::string& name, ArrayType type)
+{
+    for(auto i : range(names.size())) {
+        if(names[i]!=name)
+            continue;
+        if(cols[i]->type!=type)
+            throw NoConvert(SB()<<"TableBuilder column "<<name<<" is "<<cols[i]->type<<" not "<<type);
+        return cols[i].get();
+    }
+    throw LookupError(SB()<<"TableBuilder has no column "<<name);
+}
+
+void TableBuilder::reserve(size_t nrows)
+{
+    if(nrows <= capacity)
+        return;
+    for(auto& col : cols)
+        col->grow(this->nrows, nrows);
+    capacity = nrows;
+}
+
+Value TableBuilder::build()
+{
+    Value ret(prototype.cloneEmpty());
+    ret.assign(prototype);
+
+    for(auto i : range(cols.size())) {
+        ret[fields[i]] = cols[i]->take(nrows);
+    }
+    nrows = capacity = 0u;
+
+    return ret;
+}
+
+TableReader::TableReader(const Value& table)
+    :value(table["value"])
+{
+    if(value.type()!=TypeCode::Struct)
+        throw std::logic_error("TableReader requires a \"value\" sub-structure");
+
+    bool first = true;
+    for(auto fld : value.ichildren()) {
+        auto len = fld.as<shared_array<const void>>().size();
+        if(first || len < nrows)
+            nrows = len;
+        first = false;
+    }
+}
+
+TableReader::~TableReader() {}
+
+Value TableReader::_column(const std::string& name) const
+{
+    auto fld(value[name]);
+    if(!fld)
+        throw LookupError(SB()<<"TableReader has no column "<<name);
+    return fld;
+}
+
 TypeDef NTNDArray::build() const
 {
     using namespace pvxs::members;
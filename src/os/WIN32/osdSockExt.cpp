@@ -134,6 +134,17 @@ int recvfromx::call()
     }
 }
 
+int recvfromx::callMany(recvfromx* rx, size_t count)
+{
+    // no batched receive.  one at a time
+    int n = 0;
+    for(; size_t(n)<count; n++) {
+        if((rx[n].nrx = rx[n].call()) < 0)
+            break;
+    }
+    return n ? n : -1;
+}
+
 namespace impl {
 
 #ifndef GAA_FLAG_INCLUDE_ALL_INTERFACES
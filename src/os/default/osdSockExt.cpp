@@ -13,6 +13,8 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include <sys/types.h>
 #include <net/if.h>
 #include <ifaddrs.h>
@@ -103,100 +105,154 @@ void evsocket::enable_IP_PKTINFO() const
     }
 }
 
-int recvfromx::call()
-{
-    msghdr msg{};
-
-    iovec iov = {buf, buflen};
-    msg.msg_iov = &iov;
-    msg.msg_iovlen = 1u;
+namespace {
 
-    msg.msg_name = &(*src)->sa;
-    msg.msg_namelen = src ? src->size() : 0u;
-
-    alignas (cmsghdr) char cbuf[0u
+// only need space for IPv4 option(s) or IPv6 option, never both.
+constexpr size_t cbufSize = 0u
 #ifdef SO_RXQ_OVFL
-            + CMSG_SPACE(sizeof(ndrop))
+        + CMSG_SPACE(sizeof(uint32_t))
 #endif
-            // only need space for IPv4 option(s) or IPv6 option, never both.
-            + impl::cmax(0
+        + impl::cmax(0
 #ifdef IP_PKTINFO
-            + CMSG_SPACE(sizeof(in_pktinfo))
+        + CMSG_SPACE(sizeof(in_pktinfo))
 #else
 #  if defined(IP_ORIGDSTADDR)
-            + CMSG_SPACE(sizeof(sockaddr_in))
+        + CMSG_SPACE(sizeof(sockaddr_in))
 #  endif
 #  if defined(IP_RECVIF)
-            + CMSG_SPACE(sizeof(sockaddr_dl))
+        + CMSG_SPACE(sizeof(sockaddr_dl))
 #  endif
 #endif
-                  ,0
-            + CMSG_SPACE(sizeof(in6_pktinfo))
-                  ) // cmax
-            ];
-    msg.msg_control = cbuf;
-    msg.msg_controllen = sizeof(cbuf);
-
-    if(dst)
-        *dst = SockAddr();
-    dstif = -1;
-    ndrop = 0u;
+              ,0
+        + CMSG_SPACE(sizeof(in6_pktinfo))
+              ); // cmax
 
-    int ret = recvmsg(sock, &msg, 0);
+struct ControlBuf {
+    alignas (cmsghdr) char bytes[cbufSize];
+};
+
+void prepare(recvfromx& rx, msghdr& msg, iovec& iov, ControlBuf& cbuf)
+{
+    iov = {rx.buf, rx.buflen};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1u;
 
-    if(ret>=0) { // on success, check for control messages
-        if(msg.msg_flags & MSG_CTRUNC)
-            log_warn_printf(log, "MSG_CTRUNC, expand buffer %zu <- %zu\n", size_t(msg.msg_controllen), sizeof(cbuf));
+    msg.msg_name = &(*rx.src)->sa;
+    msg.msg_namelen = rx.src ? rx.src->size() : 0u;
 
-        for(cmsghdr *hdr = CMSG_FIRSTHDR(&msg); hdr ; hdr = CMSG_NXTHDR(&msg, hdr)) {
-            if(0) {}
+    msg.msg_control = cbuf.bytes;
+    msg.msg_controllen = sizeof(cbuf.bytes);
+
+    if(rx.dst)
+        *rx.dst = SockAddr();
+    rx.dstif = -1;
+    rx.ndrop = 0u;
+}
+
+// on success, check for control messages
+void parseControl(recvfromx& rx, msghdr& msg)
+{
+    auto dst = rx.dst;
+
+    if(msg.msg_flags & MSG_CTRUNC)
+        log_warn_printf(log, "MSG_CTRUNC, expand buffer %zu <- %zu\n", size_t(msg.msg_controllen), cbufSize);
+
+    for(cmsghdr *hdr = CMSG_FIRSTHDR(&msg); hdr ; hdr = CMSG_NXTHDR(&msg, hdr)) {
+        if(0) {}
 #ifdef SO_RXQ_OVFL
-            else if(hdr->cmsg_level==SOL_SOCKET && hdr->cmsg_type==SO_RXQ_OVFL && hdr->cmsg_len>=CMSG_LEN(sizeof(ndrop))) {
-                memcpy(&ndrop, CMSG_DATA(hdr), sizeof(ndrop));
-            }
+        else if(hdr->cmsg_level==SOL_SOCKET && hdr->cmsg_type==SO_RXQ_OVFL && hdr->cmsg_len>=CMSG_LEN(sizeof(rx.ndrop))) {
+            memcpy(&rx.ndrop, CMSG_DATA(hdr), sizeof(rx.ndrop));
+        }
 #endif
 #ifdef IP_PKTINFO
-            else if(hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in_pktinfo))) {
-                if(dst) {
-                    (*dst)->in.sin_family = AF_INET;
-                    memcpy(&(*dst)->in.sin_addr, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_addr), sizeof(in_addr_t));
-                }
-
-                decltype(in_pktinfo::ipi_ifindex) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_ifindex), sizeof(idx));
-                dstif = idx;
+        else if(hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in_pktinfo))) {
+            if(dst) {
+                (*dst)->in.sin_family = AF_INET;
+                memcpy(&(*dst)->in.sin_addr, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_addr), sizeof(in_addr_t));
             }
 
+            decltype(in_pktinfo::ipi_ifindex) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_ifindex), sizeof(idx));
+            rx.dstif = idx;
+        }
+
 #else
 #  ifdef IP_ORIGDSTADDR
-            else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_ORIGDSTADDR && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_in))) {
-                memcpy(&(*dst)->in, CMSG_DATA(hdr), sizeof(sockaddr_in));
-            }
+        else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_ORIGDSTADDR && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_in))) {
+            memcpy(&(*dst)->in, CMSG_DATA(hdr), sizeof(sockaddr_in));
+        }
 #  endif
 #  ifdef IP_RECVIF
-            else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_RECVIF && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_dl))) {
-                decltype (sockaddr_dl::sdl_index) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(sockaddr_dl, sdl_index), sizeof(idx));
-                dstif = idx;
-            }
+        else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_RECVIF && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_dl))) {
+            decltype (sockaddr_dl::sdl_index) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(sockaddr_dl, sdl_index), sizeof(idx));
+            rx.dstif = idx;
+        }
 #  endif
 #endif
-            else if(hdr->cmsg_level==IPPROTO_IPV6 && hdr->cmsg_type==IPV6_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in6_pktinfo))) {
-                if(dst) {
-                    (*dst)->in6.sin6_family = AF_INET6;
-                    memcpy(&(*dst)->in6.sin6_addr, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_addr), sizeof(in6_addr));
-                }
-
-                decltype(in6_pktinfo::ipi6_ifindex) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_ifindex), sizeof(idx));
-                dstif = idx;
+        else if(hdr->cmsg_level==IPPROTO_IPV6 && hdr->cmsg_type==IPV6_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in6_pktinfo))) {
+            if(dst) {
+                (*dst)->in6.sin6_family = AF_INET6;
+                memcpy(&(*dst)->in6.sin6_addr, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_addr), sizeof(in6_addr));
             }
+
+            decltype(in6_pktinfo::ipi6_ifindex) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_ifindex), sizeof(idx));
+            rx.dstif = idx;
         }
     }
+}
+
+} // namespace
+
+int recvfromx::call()
+{
+    msghdr msg{};
+    iovec iov;
+    ControlBuf cbuf;
+    prepare(*this, msg, iov, cbuf);
+
+    int ret = recvmsg(sock, &msg, 0);
+
+    if(ret>=0)
+        parseControl(*this, msg);
 
     return ret;
 }
 
+int recvfromx::callMany(recvfromx* rx, size_t count)
+{
+#ifdef __linux__
+    // batch size limited to keep working arrays on stack
+    constexpr size_t maxBatch = 64u;
+    count = std::min(count, maxBatch);
+
+    mmsghdr msgs[maxBatch];
+    iovec iovs[maxBatch];
+    ControlBuf cbufs[maxBatch];
+
+    memset(msgs, 0, count*sizeof(msgs[0]));
+    for(size_t i=0u; i<count; i++)
+        prepare(rx[i], msgs[i].msg_hdr, iovs[i], cbufs[i]);
+
+    int ret = recvmmsg(rx[0].sock, msgs, count, 0, nullptr);
+
+    for(int i=0; i<ret; i++) {
+        rx[i].nrx = int(msgs[i].msg_len);
+        parseControl(rx[i], msgs[i].msg_hdr);
+    }
+
+    return ret;
+#else
+    int n = 0;
+    for(; size_t(n)<count; n++) {
+        if((rx[n].nrx = rx[n].call()) < 0)
+            break;
+    }
+    return n ? n : -1;
+#endif
+}
+
 namespace impl {
 
 decltype (IfaceMap::byIndex) IfaceMap::_refresh() {
@@ -209,9 +209,18 @@ struct recvfromx {
     SockAddr* dst;  // if enable_IP_PKTINFO()
     int64_t dstif;  // if enable_IP_PKTINFO(), destination interface index
     uint32_t ndrop; // if enable_SO_RXQ_OVFL()
+    int nrx;        // from callMany(), length received
 
     PVXS_API
     int call();
+
+    /* Receive up to count datagrams into rx[0] through rx[count-1], which must
+     * all use the same socket.  Uses one recvmmsg() call where available.
+     * Returns the number of entries filled in, each as by call() with length nrx,
+     * or -1 if none were received.
+     */
+    PVXS_API
+    static int callMany(recvfromx* rx, size_t count);
 };
 
 } // namespace pvxs
@@ -66,6 +66,16 @@ public:
     inline const char* file() const { return err ? err : "(null)"; }
     EPICS_ALWAYS_INLINE int line() const { return errline; }
 
+    // Append the first nbytes of arr by reference instead of copying.
+    // Only possible when the bytes are already in wire order.
+    // Returns false if not supported, in which case nothing is appended.
+    virtual bool reference(const shared_array<const void>& arr, size_t nbytes);
+
+    // Remove the next nbytes into dest, which need not be in the current slice.
+    // Returns false if not supported, or fewer than nbytes remain,
+    // in which case nothing is removed.
+    virtual bool copyOut(void* dest, size_t nbytes);
+
     // ensure (be resize/refill) that size()>=i
     inline bool ensure(size_t i) {
         return !err && (i<=size() || refill(i));
@@ -143,6 +153,7 @@ public:
     {refill(isize);}
     virtual ~EvOutBuf();
     virtual bool refill(size_t more) override final;
+    virtual bool reference(const shared_array<const void>& arr, size_t nbytes) override final;
 };
 
 //! deserialize from an evbuffer, possibly segmented
@@ -161,8 +172,35 @@ public:
     virtual ~EvInBuf();
 
     virtual bool refill(size_t more) override final;
+    virtual bool copyOut(void* dest, size_t nbytes) override final;
+};
+
+//! Implementations of copySwapped()
+enum struct SwapKernel {
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON,
 };
 
+PVXS_API
+const char* swapKernelName(SwapKernel id);
+
+//! The kernel used by copySwapped(), selected at runtime for this CPU.
+PVXS_API
+SwapKernel swapKernelSelected();
+
+/** Copy count elements of width bytes (1, 2, 4, or 8) from src to dest,
+ *  reversing the byte order of each element.  src and dest must either
+ *  not overlap, or be the same (swap in place).  Need not be aligned.
+ */
+PVXS_API
+void copySwapped(void* dest, const void* src, size_t count, size_t width);
+
+//! As copySwapped() with a specific kernel.  Returns false if not supported by this host.
+PVXS_API
+bool copySwappedWith(SwapKernel id, void* dest, const void* src, size_t count, size_t width);
+
 // assumes prior buf.ensure(M) where M>=N
 template<unsigned N>
 inline void _to_wire(Buffer& buf, const uint8_t *mem, bool reverse, const char *fname, int lineno)
@@ -399,7 +437,10 @@ void from_wire(Buffer& buf, std::string& s)
         buf.fault(__FILE__, __LINE__);
 
     } else {
-        s = std::string((char*)buf.save(), len.size);
+        auto bytes = (const char*)buf.save();
+        // repeated values are common (eg. units).  Skip when unchanged, and otherwise re-use capacity.
+        if(len.size!=s.size() || memcmp(bytes, s.data(), len.size)!=0)
+            s.assign(bytes, len.size);
         buf._skip(len.size);
     }
 }
@@ -483,8 +524,21 @@ void to_wire(Buffer& buf, const shared_array<const void>& varr)
 
         auto src = reinterpret_cast<const char*>(arr.data());
 
-        for(size_t nremain = arr.size()*sizeof(C); nremain;) {
-            if(!buf.ensure(sizeof(C))) {
+        // limit on contiguous space requested at once.  eg. from an evbuffer
+        constexpr size_t max_reserve = 1u<<20u;
+        // smaller arrays are copied, which is cheaper than tracking a reference
+        constexpr size_t min_reference = 1u<<16u;
+
+        size_t nremain = arr.size()*sizeof(C);
+
+        if(buf.be==hostBE && sizeof(E)==sizeof(C) && nremain>=min_reference && buf.reference(varr, nremain)) {
+            nremain = 0u; // zero copy
+        }
+
+        for(; nremain;) {
+            // when out of space, prefer one large region (fewer, larger copies)
+            // but accept a single element.
+            if(buf.size()<sizeof(C) && !buf.ensure(std::min(nremain, max_reserve)) && !buf.ensure(sizeof(C))) {
                 buf.fault(__FILE__, __LINE__);
                 break;
             }
@@ -496,14 +550,7 @@ void to_wire(Buffer& buf, const shared_array<const void>& varr)
                 memcpy(buf.save(), src, nbytes);
 
             } else { // must swap byte order
-                auto dest = buf.save();
-
-                for(size_t i=0; i<nbytes; i+=sizeof(C)) {
-                    for(size_t n=0u; n<sizeof(C); n++) {
-                        dest[i + sizeof(C)-1-n] = src[i + n];
-
-                    }
-                }
+                copySwapped(buf.save(), src, nbytes/sizeof(C), sizeof(C));
             }
 
             src += nbytes;
@@ -532,7 +579,16 @@ void from_wire(Buffer& buf, shared_array<const void>& varr)
 
         auto dest = reinterpret_cast<char*>(arr.data());
 
-        for(size_t nremain = arr.size()*sizeof(C); nremain;) {
+        size_t nremain = arr.size()*sizeof(C);
+
+        // when not already contiguous, copy directly from the backing buffer.  eg. evbuffer chains
+        if(nremain > buf.size() && sizeof(E)==sizeof(C) && buf.copyOut(dest, nremain)) {
+            if(buf.be!=hostBE)
+                copySwapped(dest, dest, arr.size(), sizeof(C));
+            nremain = 0u;
+        }
+
+        for(; nremain;) {
             if(!buf.ensure(sizeof(C))) {
                 buf.fault(__FILE__, __LINE__);
                 break;
@@ -545,14 +601,7 @@ void from_wire(Buffer& buf, shared_array<const void>& varr)
                 memcpy(dest, buf.save(), nbytes);
 
             } else { // must swap byte order
-                auto src = buf.save();
-
-                for(size_t i=0; i<nbytes; i+=sizeof(C)) {
-                    for(size_t n=0u; n<sizeof(C); n++) {
-                        dest[i + sizeof(C)-1-n] = src[i + n];
-
-                    }
-                }
+                copySwapped(dest, buf.save(), nbytes/sizeof(C), sizeof(C));
             }
 
             dest += nbytes;
@@ -680,6 +729,17 @@ void to_wire(Buf& buf, const Header& H)
 
 void to_evbuf(evbuffer *buf, const Header& H, bool be);
 
+/** Move all of body into buf as a message with header H.
+ *  Bodies longer than maxSegment are split into segments,
+ *  at evbuffer chain boundaries where possible.  A single chain
+ *  longer than maxSegment is not split (so not copied) unless
+ *  it exceeds the maximum segment length.
+ *  H.len and segmentation flags are ignored.
+ *  @returns Number of bytes added to buf, including headers.
+ */
+PVXS_API
+size_t to_evbuf(evbuffer *buf, Header H, evbuffer *body, bool be, size_t maxSegment);
+
 template<typename Buf>
 void from_wire(Buf& buf, Header& H)
 {
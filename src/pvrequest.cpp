@@ -79,14 +79,12 @@ bool testmask(const Value& update, const BitMask& mask)
     if(!desc)
         return false;
 
-    if(store->valid && mask[0])
-        return true;
+    BitMask valid;
+    collectValid(valid, store, desc->code==TypeCode::Struct ? desc->size() : 1u);
 
-    if(desc->code==TypeCode::Struct) {
-        for(auto idx : range(size_t(1u), desc->size())) {
-            if(store[idx].valid && mask[idx])
-                return true;
-        }
+    for(auto i : range(std::min(valid.wsize(), mask.wsize()))) {
+        if(valid.word(i) & mask.word(i))
+            return true;
     }
 
     return false;
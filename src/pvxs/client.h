@@ -870,6 +870,7 @@ class MonitorBuilder : public detail::CommonBuilder<MonitorBuilder, detail::Comm
     std::function<void(Subscription&)> _event;
     bool _maskConn = true;
     bool _maskDisconn = false;
+    bool _deltas = false;
 public:
     MonitorBuilder() {}
     MonitorBuilder(const std::shared_ptr<Context::Pvt>& ctx, const std::string& name) :CommonBuilder{ctx,name} {}
@@ -886,6 +887,16 @@ public:
     MonitorBuilder& maskConnected(bool m = true) { _maskConn = m; return *this; }
     //! Include Disconnected exceptions in queue (default true).
     MonitorBuilder& maskDisconnected(bool m = true) { _maskDisconn = m; return *this; }
+    /** Queue only the fields changed by each update (default false).
+     *
+     *  By default, each update is completed with the last received value of unchanged fields,
+     *  at a cost proportional to the size of the structure.
+     *  With deltas, unmarked fields of a Value returned by Subscription::pop() are empty.
+     *  Only Value::isMarked() fields are meaningful.
+     *
+     *  @since UNRELEASED
+     */
+    MonitorBuilder& deltas(bool d = true) { _deltas = d; return *this; }
 
 #ifdef PVXS_EXPERT_API_ENABLED
     // called during operation INIT phase for Get/Put/Monitor when remote type
@@ -1034,6 +1045,12 @@ struct PVXS_API Config {
     //! @since 0.2.0
     double tcpTimeout = 40.0;
 
+    //! Number of worker threads servicing TCP connections.
+    //! Channels are assigned to workers by PV name, and each worker maintains its own connections.
+    //! Zero (default) services all connections from the thread which also handles searching.
+    //! @since UNRELEASED
+    unsigned nWorkers = 0u;
+
 private:
     bool BE = EPICS_BYTE_ORDER==EPICS_ENDIAN_BIG;
     bool UDP = true;
@@ -487,6 +487,38 @@ struct PVXS_API LookupError : public std::runtime_error
     virtual ~LookupError();
 };
 
+/** A descendant field name which has been resolved once, for repeated use.
+ *
+ * Obtained from Value::handle().  Use with Value::operator[](const FieldHandle&).
+ * Lookup in a Value with the same type as the original is a direct offset.
+ * Otherwise (or for names which traverse a Union, Any, or array) the name is looked up as usual.
+ *
+ * @code
+ * auto hval(val.handle("value"));
+ * for(...) {
+ *     auto update(val.cloneEmpty());
+ *     update[hval] = 42;
+ * }
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+class PVXS_API FieldHandle {
+    friend class Value;
+    // type in which the name was resolved.  NULL if only the name is usable
+    std::shared_ptr<const impl::FieldDesc> base;
+    // offset from base, when base!=NULL
+    size_t offset = 0u;
+    std::string _name;
+public:
+    FieldHandle() = default;
+    //! The field name, or path, which this handle refers to.
+    inline const std::string& name() const { return _name; }
+    //! Does this handle refer to some field
+    inline bool valid() const { return !_name.empty(); }
+    inline explicit operator bool() const { return valid(); }
+};
+
 /** Generic data container
  *
  * References a single data field, which may be free-standing (eg. "int x = 5;")
@@ -607,6 +639,11 @@ public:
     bool tryCopyOut(void *ptr, StoreType type) const;
     void copyIn(const void *ptr, StoreType type);
     bool tryCopyIn(const void *ptr, StoreType type);
+    // equivalent to (*this)[handle].copyOut(ptr, type) et al.
+    // @since UNRELEASED
+    void copyOut(const FieldHandle& handle, void *ptr, StoreType type) const;
+    bool tryCopyOut(const FieldHandle& handle, void *ptr, StoreType type) const;
+    void copyIn(const FieldHandle& handle, const void *ptr, StoreType type);
 
     /** Extract from field.
      *
@@ -738,6 +775,25 @@ public:
     Value lookup(const std::string& name);
     const Value lookup(const std::string& name) const;
 
+    /** Resolve a descendant field name for later use with operator[](const FieldHandle&).
+     *
+     * Accepts the same expressions as lookup().
+     *
+     * @throws LookupError If the lookup can not be satisfied
+     * @throws NoField If this Value is empty
+     * @since UNRELEASED
+     */
+    FieldHandle handle(const std::string& name) const;
+
+    /** Access a descendant field through a handle from handle().
+     *
+     * Acts like operator[](handle.name())
+     *
+     * @since UNRELEASED
+     */
+    Value operator[](const FieldHandle& handle);
+    const Value operator[](const FieldHandle& handle) const;
+
     //! Number of child fields.
     //! only Struct, StructA, Union, UnionA return non-zero
     //! \since 1.1.3 correctly return non-zero for StructA and UnionA
@@ -934,6 +990,244 @@ Value::imarked() const noexcept {
     return Iterable<Value::_IMarked>{this};
 }
 
+namespace impl {
+//! @throws NoConvert if a field with the storage type of fld could never be converted to/from type
+PVXS_API
+void checkFieldRef(const Value& fld, const std::string& name, StoreType type);
+} // namespace impl
+
+/** Typed access to one field, resolved once for repeated use.
+ *
+ * Holds a FieldHandle, so access to a Value with the same type as the prototype
+ * is a direct offset.  T may be any type accepted by Value::as<T>() and Value::from<T>().
+ * Other types fail to compile.
+ *
+ * @code
+ * auto prototype(nt::NTScalar{TypeCode::Float64}.create());
+ * FieldRef<double> fvalue(prototype, "value");
+ * FieldRef<int32_t> fsevr(prototype, "alarm.severity");
+ * for(...) {
+ *     auto update(prototype.cloneEmpty());
+ *     fvalue.set(update, 4.2);
+ *     fsevr.set(update, 0);
+ *     ...
+ * }
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+template<typename T>
+class FieldRef {
+    typedef typename impl::StoreAs<T>::store_t store_t;
+    static constexpr StoreType code = impl::StoreAs<T>::code;
+
+    FieldHandle _handle;
+public:
+    typedef T value_type;
+
+    FieldRef() = default;
+    /** Resolve name in a Value of the type to be accessed
+     *
+     * @throws LookupError If the lookup can not be satisfied
+     * @throws NoConvert If the field could never be converted to/from T.  eg. a Struct as a double.
+     */
+    FieldRef(const Value& prototype, const std::string& name)
+        :_handle(prototype.handle(name))
+    {
+        impl::checkFieldRef(prototype[_handle], name, code);
+    }
+    //! Resolve name in the type to be accessed
+    FieldRef(const TypeDef& def, const std::string& name)
+        :FieldRef(def.create(), name)
+    {}
+
+    //! Equivalent to val[name].as<T>()
+    inline T get(const Value& val) const {
+        store_t ret;
+        val.copyOut(_handle, &ret, code);
+        return impl::StoreTransform<T>::out(ret);
+    }
+    //! Equivalent to val[name].as<T>(out)
+    inline bool get(const Value& val, T& out) const {
+        store_t temp;
+        auto ret = val.tryCopyOut(_handle, &temp, code);
+        if(ret) {
+            try {
+                out = impl::StoreTransform<T>::out(temp);
+            }catch(std::exception&){
+                ret = false;
+            }
+        }
+        return ret;
+    }
+    //! Equivalent to val[name].from<T>(v)
+    inline void set(Value& val, const T& v) const {
+        const store_t& norm(impl::StoreTransform<T>::in(v));
+        val.copyIn(_handle, &norm, code);
+    }
+
+    //! The field name, or path
+    inline const std::string& name() const { return _handle.name(); }
+    inline const FieldHandle& handle() const { return _handle; }
+    inline bool valid() const { return _handle.valid(); }
+    inline explicit operator bool() const { return valid(); }
+};
+
+template<typename T>
+constexpr StoreType FieldRef<T>::code;
+
+namespace impl {
+// TypeCode of a field to hold a struct member of type M
+template<typename M, typename Enable=void>
+struct MemberCode {
+    static constexpr TypeCode code() { return TypeCode(ScalarMap<M>::code); }
+};
+template<typename M>
+struct MemberCode<M, typename std::enable_if<std::is_enum<M>::value>::type> {
+    static constexpr TypeCode code() { return MemberCode<typename std::underlying_type<M>::type>::code(); }
+};
+template<typename E>
+struct MemberCode<shared_array<const E>> {
+    static constexpr TypeCode code() { return MemberCode<E>::code().arrayOf(); }
+};
+} // namespace impl
+
+//! Shorthand for the name and pointer of a struct member. @see StructMap::add()
+#define PVXS_MEMBER(TYPE, NAME) #NAME, &TYPE::NAME
+
+/** Mapping between the members of a C++ struct and the fields of a Value.
+ *
+ * Field types are deduced from member types.
+ * Each field is resolved once, when added, so store() and load()
+ * are a typed access per member without any name lookups.
+ *
+ * The mapping, and the resulting type, are built at run time.
+ * Mapped fields are held, and (de)serialized, by a Value as usual.
+ * eg. a float member is stored in a Float32 field as a double.
+ *
+ * @code
+ * struct Point { double x; float y; int32_t severity; std::string label; };
+ * static const auto pointMap(StructMap<Point>("point_t")
+ *                            .add(PVXS_MEMBER(Point, x))
+ *                            .add(PVXS_MEMBER(Point, y))
+ *                            .add(PVXS_MEMBER(Point, label)));
+ * Point pt{1.0, 2.0f, 0, "origin"};
+ * Value val(pointMap.create());
+ * pointMap.store(val, pt);
+ * @endcode
+ *
+ * Alternately, members may be mapped onto the fields of an existing type.
+ *
+ * @code
+ * static const auto scalarMap(StructMap<Point>(nt::NTScalar{TypeCode::Float64}.build())
+ *                             .add("value", &Point::x)
+ *                             .add("alarm.severity", &Point::severity)
+ *                             .add("alarm.message", &Point::label));
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+template<typename T>
+class StructMap {
+    struct Binding {
+        virtual ~Binding() {}
+        virtual Binding* clone() const =0;
+        virtual void resolve(const Value& prototype) =0;
+        virtual void store(Value& val, const T& obj) const =0;
+        virtual bool load(const Value& val, T& obj) const =0;
+    };
+    template<typename M>
+    struct MemberBinding final : public Binding {
+        const std::string name;
+        M T::* const member;
+        FieldRef<M> ref;
+        MemberBinding(const std::string& name, M T::* member) :name(name), member(member) {}
+        virtual ~MemberBinding() {}
+        virtual Binding* clone() const override final {
+            return new MemberBinding(*this);
+        }
+        virtual void resolve(const Value& prototype) override final {
+            ref = FieldRef<M>(prototype, name);
+        }
+        virtual void store(Value& val, const T& obj) const override final {
+            ref.set(val, obj.*member);
+        }
+        virtual bool load(const Value& val, T& obj) const override final {
+            return ref.get(val, obj.*member);
+        }
+    };
+
+    TypeDef def;
+    Value prototype;
+    std::vector<std::unique_ptr<Binding>> bindings;
+public:
+    //! Begin with an empty Struct.  Each add() appends a field.
+    explicit StructMap(const std::string& id = std::string())
+        :def(TypeCode::Struct, id, {})
+        ,prototype(def.create())
+    {}
+    //! Begin with an existing type.  add() maps a member onto an existing field, or appends a new one.
+    explicit StructMap(const TypeDef& def)
+        :def(def)
+        ,prototype(def.create())
+    {}
+    StructMap(const StructMap& o)
+        :def(o.def)
+        ,prototype(o.prototype)
+    {
+        bindings.reserve(o.bindings.size());
+        for(auto& b : o.bindings)
+            bindings.emplace_back(b->clone());
+    }
+    StructMap(StructMap&&) = default;
+
+    /** Map a member onto the named field, appending the field if not already present.
+     *
+     * @throws LookupError If name is a path to a field which is not present, or other invalid name.
+     * @throws NoConvert If an existing field could never be converted to/from M.
+     */
+    template<typename M>
+    StructMap& add(const std::string& name, M T::* member) {
+        std::unique_ptr<Binding> binding(new MemberBinding<M>(name, member));
+        if(!prototype[name] && name.find_first_of(".[<-") == std::string::npos) {
+            def += {Member(impl::MemberCode<M>::code(), name)};
+            auto proto(def.create());
+            for(auto& b : bindings)
+                b->resolve(proto);
+            prototype = proto;
+        }
+        binding->resolve(prototype);
+        bindings.push_back(std::move(binding));
+        return *this;
+    }
+
+    //! The type, including any fields appended by add()
+    const TypeDef& type() const { return def; }
+    //! Instantiate
+    Value create() const { return prototype.cloneEmpty(); }
+
+    //! Assign, and mark, the field of each mapped member.
+    //! @pre val has the type of create()
+    void store(Value& val, const T& obj) const {
+        for(auto& b : bindings)
+            b->store(val, obj);
+    }
+    //! Copy each mapped field to its member.  Returns false if any field could not be converted.
+    //! @pre val has the type of create()
+    bool load(const Value& val, T& obj) const {
+        bool ok = true;
+        for(auto& b : bindings)
+            ok &= b->load(val, obj);
+        return ok;
+    }
+    //! A new Value with all mapped fields assigned from obj
+    Value create(const T& obj) const {
+        auto ret(create());
+        store(ret, obj);
+        return ret;
+    }
+};
+
 PVXS_API
 std::ostream& operator<<(std::ostream& strm, const Value::Fmt& fmt);
 
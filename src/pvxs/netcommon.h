@@ -63,8 +63,22 @@ struct Report {
         std::list<Channel> channels;
     };
 
+    //! Info for a single thread servicing TCP connections
+    //! @since UNRELEASED
+    struct Worker {
+        //! worker thread name
+        std::string name;
+        //! Number of sockets currently serviced by this worker
+        size_t connections{};
+        //! sum of transmit and receive counters in bytes of these sockets
+        size_t tx{}, rx{};
+    };
+
     //! Currently open sockets
     std::list<Connection> connections;
+    //! TCP worker threads, and the load on each
+    //! @since UNRELEASED
+    std::list<Worker> workers;
 };
 
 struct PVXS_API ReportInfo {
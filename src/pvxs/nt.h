@@ -7,6 +7,9 @@
 #define PVXS_NT_H
 
 #include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
 
 #include <pvxs/version.h>
 #include <pvxs/data.h>
@@ -145,6 +148,206 @@ private:
     std::shared_ptr<Pvt> pvt;
 };
 
+namespace detail {
+template<size_t...> struct idx_seq {};
+template<size_t N, size_t... I> struct make_idx_seq : make_idx_seq<N-1u, N-1u, I...> {};
+template<size_t... I> struct make_idx_seq<0u, I...> { typedef idx_seq<I...> type; };
+
+// storage for one column of a TableBuilder
+struct PVXS_API TableColumnBase {
+    const ArrayType type;
+    explicit TableColumnBase(ArrayType type) :type(type) {}
+    virtual ~TableColumnBase();
+    // re-allocate with capacity, keeping the first nrows
+    virtual void grow(size_t nrows, size_t capacity) =0;
+    // hand over the first nrows, and forget storage
+    virtual shared_array<const void> take(size_t nrows) =0;
+};
+
+template<typename T>
+struct TableColumn final : public TableColumnBase {
+    std::shared_ptr<T> buf;
+    T* data = nullptr;
+
+    TableColumn() :TableColumnBase(pvxs::detail::CaptureBase<T>::code) {}
+    virtual ~TableColumn() {}
+    virtual void grow(size_t nrows, size_t capacity) override final {
+        std::shared_ptr<T> nbuf(new T[capacity](), pvxs::detail::sa_default_delete<T>());
+        std::move(data, data+nrows, nbuf.get());
+        buf = std::move(nbuf);
+        data = buf.get();
+    }
+    virtual shared_array<const void> take(size_t nrows) override final {
+        shared_array<const T> ret(buf, data, nrows); // alias
+        buf.reset();
+        data = nullptr;
+        return ret.template castTo<const void>();
+    }
+};
+} // namespace detail
+
+/** Fill in the columns of an NTTable row by row.
+ *
+ *  Each column is stored as a contiguous typed array, which is handed over
+ *  to the result of build() without copying.
+ *
+ * @code
+ * auto prototype(nt::NTTable{}
+ *                .add_column(TypeCode::Float64, "x")
+ *                .add_column(TypeCode::String, "name")
+ *                .create());
+ * nt::TableBuilder table(prototype);
+ * auto x(table.column<double>("x"));
+ * auto name(table.column<std::string>("name"));
+ * for(...) {
+ *     auto row(table.append());
+ *     x[row] = 4.2;
+ *     name[row] = "something";
+ * }
+ * Value update(table.build());
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+class PVXS_API TableBuilder {
+public:
+    //! Access to the cells of one column
+    template<typename T>
+    class Column {
+        friend class TableBuilder;
+        detail::TableColumn<T>* col = nullptr;
+        explicit Column(detail::TableColumn<T>* col) :col(col) {}
+    public:
+        Column() = default;
+        //! Cell of a row.  Cells of new rows are zero or empty.
+        //! The reference is invalidated by append(), reserve(), or build().
+        //! @pre row < TableBuilder::size()
+        T& operator[](size_t row) const { return col->data[row]; }
+    };
+
+    /** @param prototype A Value with a "value" sub-structure of scalar array columns.
+     *         eg. from NTTable::create().
+     *  @throws std::logic_error if prototype has no such "value"
+     */
+    explicit TableBuilder(const Value& prototype);
+    ~TableBuilder();
+    TableBuilder(TableBuilder&&) = default;
+    TableBuilder& operator=(TableBuilder&&) = default;
+
+    /** Access the column with this field name.
+     *  @throws LookupError if no such column
+     *  @throws NoConvert if T is not the column element type.
+     */
+    template<typename T>
+    Column<T> column(const std::string& name) {
+        return Column<T>(static_cast<detail::TableColumn<T>*>(_column(name, pvxs::detail::CaptureBase<T>::code)));
+    }
+
+    //! Number of rows appended since build()
+    size_t size() const { return nrows; }
+
+    //! Allocate storage for at least nrows before next build()
+    void reserve(size_t nrows);
+
+    //! Add one row.  Returns its index.
+    size_t append() {
+        if(nrows==capacity)
+            reserve(capacity ? 2u*capacity : 16u);
+        return nrows++;
+    }
+
+    /** A Value with the fields of prototype which are marked (eg. "labels"),
+     *  and all columns assigned.  Then begin again with zero rows.
+     */
+    Value build();
+
+private:
+    detail::TableColumnBase* _column(const std::string& name, ArrayType type);
+
+    Value prototype;
+    std::vector<std::string> names;
+    std::vector<FieldHandle> fields;
+    std::vector<std::unique_ptr<detail::TableColumnBase>> cols;
+    size_t nrows = 0u, capacity = 0u;
+};
+
+/** Read access to the columns of an NTTable.
+ *
+ * @code
+ * nt::TableReader table(update);
+ * auto x(table.column<double>("x")); // all rows, without copy
+ * for(auto row : table.rows<double, std::string>("x", "name")) {
+ *     std::cout<<std::get<0>(row)<<" "<<std::get<1>(row)<<"\n";
+ * }
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+class PVXS_API TableReader {
+public:
+    //! Iterable over the cells of several columns, row by row
+    template<typename... T>
+    class Rows {
+        friend class TableReader;
+        std::tuple<shared_array<const T>...> cols;
+        size_t nrows;
+        Rows(size_t nrows, shared_array<const T>&&... cols) :cols(std::move(cols)...), nrows(nrows) {}
+    public:
+        class iterator {
+            friend class Rows;
+            const Rows* rows;
+            size_t row;
+            iterator(const Rows* rows, size_t row) :rows(rows), row(row) {}
+            template<size_t... I>
+            std::tuple<const T&...> get(detail::idx_seq<I...>) const {
+                return std::tuple<const T&...>(std::get<I>(rows->cols)[row]...);
+            }
+        public:
+            //! Cells of the current row
+            std::tuple<const T&...> operator*() const {
+                return get(typename detail::make_idx_seq<sizeof...(T)>::type());
+            }
+            iterator& operator++() { row++; return *this; }
+            bool operator==(const iterator& o) const { return row==o.row; }
+            bool operator!=(const iterator& o) const { return row!=o.row; }
+            //! Index of the current row
+            size_t index() const { return row; }
+        };
+        iterator begin() const { return iterator(this, 0u); }
+        iterator end() const { return iterator(this, nrows); }
+        size_t size() const { return nrows; }
+    };
+
+    //! @throws std::logic_error if table has no "value" sub-structure
+    explicit TableReader(const Value& table);
+    ~TableReader();
+
+    //! Number of rows.  The length of the shortest column.
+    size_t size() const { return nrows; }
+
+    /** All cells of a column.  Without copying when T is the column element type,
+     *  otherwise converted.
+     *  @throws LookupError if no such column
+     */
+    template<typename T>
+    shared_array<const T> column(const std::string& name) const {
+        return _column(name).as<shared_array<const T>>();
+    }
+
+    //! Iterate over the named columns, one per T
+    template<typename... T, typename... N>
+    Rows<T...> rows(const N&... names) const {
+        static_assert(sizeof...(T)==sizeof...(N), "one column name per type");
+        return Rows<T...>(nrows, column<T>(names)...);
+    }
+
+private:
+    Value _column(const std::string& name) const;
+
+    Value value;
+    size_t nrows = 0u;
+};
+
 /** The areaDetector inspired N-dimension array/image container.
  *
  * @code
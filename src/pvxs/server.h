@@ -175,6 +175,27 @@ struct PVXS_API Config {
     //! @since 0.2.0
     double tcpTimeout = 40.0;
 
+    //! Number of worker threads servicing accepted TCP connections.
+    //! New connections are assigned to the least loaded worker.
+    //! Zero (default) services all connections from the thread which accepts them.
+    //! @since UNRELEASED
+    unsigned nWorkers = 0u;
+
+    //! Remember for this many seconds those names, searched for via UDP, which no Source claimed.
+    //! Sources are not asked again about a remembered name.
+    //! Adding or removing a Source, or a name in a StaticSource, forgets all names.
+    //! Other changes in the names a Source will claim are noticed only once the timeout expires.
+    //! Zero (default) disables.
+    //! @since UNRELEASED
+    double searchCacheTimeout = 0.0;
+
+    //! Limit the number of UDP search requests processed from each client IP address.
+    //! In requests per second, with up to one second worth accepted in a burst.
+    //! Excess requests are ignored, and will be retried by the client.
+    //! Zero (default) disables.
+    //! @since UNRELEASED
+    double searchRate = 0.0;
+
     //! Server unique ID.  Only meaningful in readback via Server::config()
     ServerGUID guid{};
 
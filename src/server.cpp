@@ -7,10 +7,12 @@
 
 #include <list>
 #include <map>
+#include <algorithm>
 #include <system_error>
 #include <functional>
 #include <atomic>
 #include <cstdlib>
+#include <cstring>
 
 #include <signal.h>
 
@@ -32,6 +34,214 @@
 namespace pvxs {
 namespace impl {
 ReportInfo::~ReportInfo() {}
+
+typedef epicsGuard<epicsMutex> Guard;
+
+// bloom filter probes per name
+static constexpr unsigned bloomK = 3u;
+// grow the bloom filter to keep at least this many counters per name
+static constexpr size_t bloomRatio = 8u;
+
+static_assert(SearchIndex::nshards==16u, "shardOf() uses top 4 bits of hash");
+
+SearchIndex::SearchIndex()
+    :bloom(1024u, 0u)
+{}
+
+SearchIndex::~SearchIndex() {}
+
+uint64_t SearchIndex::hash(const char* name)
+{
+    // FNV-1a
+    uint64_t h = 0xcbf29ce484222325ull;
+    for(; *name; name++) {
+        h ^= uint8_t(*name);
+        h *= 0x100000001b3ull;
+    }
+    return h;
+}
+
+void SearchIndex::bloomAdjust(uint64_t h, bool inc)
+{
+    const size_t mask = bloom.size()-1u;
+    const uint64_t step = (h>>32u) | 1u;
+    for(auto i : range(bloomK)) {
+        auto& ctr = bloom[(h + i*step)&mask];
+        // once saturated, a counter is left set until the next bloomRebuild()
+        if(ctr==0xffu)
+            continue;
+        if(inc)
+            ctr++;
+        else if(ctr)
+            ctr--;
+    }
+}
+
+void SearchIndex::bloomRebuild(size_t nbuckets)
+{
+    // with writeLock and bloomLock held for write
+    bloom.assign(nbuckets, 0u);
+    for(auto& shard : shards) {
+        Guard G(shard.lock);
+        for(auto& pair : shard.names) {
+            bloomAdjust(pair.first, true);
+        }
+    }
+}
+
+void SearchIndex::add(const std::string& name)
+{
+    auto h = hash(name.c_str());
+    auto& shard = shardOf(h);
+
+    Guard W(writeLock);
+    {
+        Guard G(shard.lock);
+        auto R(shard.names.equal_range(h));
+        for(auto it = R.first; it!=R.second; ++it) {
+            if(it->second.name==name) {
+                it->second.refs++;
+                return;
+            }
+        }
+        shard.names.emplace(h, Entry{name, 1u});
+    }
+    nnames++;
+    nchanges++;
+
+    auto B(bloomLock.lockWriter());
+    if(nnames*bloomRatio > bloom.size()) {
+        bloomRebuild(bloom.size()*2u);
+    } else {
+        bloomAdjust(h, true);
+    }
+}
+
+void SearchIndex::remove(const std::string& name)
+{
+    auto h = hash(name.c_str());
+    auto& shard = shardOf(h);
+
+    Guard W(writeLock);
+    {
+        Guard G(shard.lock);
+        auto R(shard.names.equal_range(h));
+        auto it = R.first;
+        while(it!=R.second && it->second.name!=name)
+            ++it;
+        if(it==R.second || --it->second.refs)
+            return;
+        shard.names.erase(it);
+    }
+    nnames--;
+    nchanges++;
+
+    auto B(bloomLock.lockWriter());
+    bloomAdjust(h, false);
+}
+
+bool SearchIndex::contains(const char* name) const
+{
+    auto h = hash(name);
+    {
+        auto B(bloomLock.lockReader());
+        const size_t mask = bloom.size()-1u;
+        const uint64_t step = (h>>32u) | 1u;
+        for(auto i : range(bloomK)) {
+            if(!bloom[(h + i*step)&mask])
+                return false;
+        }
+    }
+
+    auto& shard = shardOf(h);
+    Guard G(shard.lock);
+    auto R(shard.names.equal_range(h));
+    for(auto it = R.first; it!=R.second; ++it) {
+        if(it->second.name==name)
+            return true;
+    }
+    return false;
+}
+
+size_t SearchIndex::size() const
+{
+    Guard W(writeLock);
+    return nnames;
+}
+
+bool NegativeSearchCache::contains(const char* name, const epicsTimeStamp& now, double tmo) const
+{
+    auto R(entries.equal_range(SearchIndex::hash(name)));
+    for(auto it = R.first; it!=R.second; ++it) {
+        if(it->second.name==name) {
+            auto age = epicsTimeDiffInSeconds(&now, &it->second.added);
+            return age>=0.0 && age<tmo;
+        }
+    }
+    return false;
+}
+
+void NegativeSearchCache::insert(const char* name, const epicsTimeStamp& now, double tmo)
+{
+    auto h = SearchIndex::hash(name);
+    auto R(entries.equal_range(h));
+    for(auto it = R.first; it!=R.second; ++it) {
+        if(it->second.name==name) {
+            it->second.added = now;
+            return;
+        }
+    }
+
+    if(entries.size() >= limit) {
+        for(auto it = entries.begin(); it!=entries.end();) {
+            auto age = epicsTimeDiffInSeconds(&now, &it->second.added);
+            if(age<0.0 || age>=tmo)
+                it = entries.erase(it);
+            else
+                ++it;
+        }
+        // Overloaded.  Forget everything rather than spend more time choosing.
+        if(entries.size() >= limit)
+            entries.clear();
+    }
+
+    entries.emplace(h, Entry{name, now});
+}
+
+bool SearchRateLimit::allow(const SockAddr& peer, const epicsTimeStamp& now, double rate, double burst)
+{
+    auto it = buckets.find(peer);
+
+    if(it==buckets.end()) {
+        if(buckets.size() >= limit) {
+            // a bucket which would be full again holds no information.  forget it.
+            for(auto cur = buckets.begin(); cur!=buckets.end();) {
+                auto& B = cur->second;
+                if(B.tokens + epicsTimeDiffInSeconds(&now, &B.last)*rate >= burst)
+                    cur = buckets.erase(cur);
+                else
+                    ++cur;
+            }
+            if(buckets.size() >= limit)
+                buckets.clear();
+        }
+        it = buckets.emplace(peer, Bucket{burst, now}).first;
+
+    } else {
+        auto& B = it->second;
+        auto dT = epicsTimeDiffInSeconds(&now, &B.last);
+        if(dT>0.0)
+            B.tokens = std::min(burst, B.tokens + dT*rate);
+        B.last = now;
+    }
+
+    auto& B = it->second;
+    if(B.tokens < 1.0)
+        return false;
+    B.tokens -= 1.0;
+    return true;
+}
+
 }
 namespace server {
 using namespace impl;
@@ -92,6 +302,7 @@ Server& Server::addSource(const std::string& name,
         if(ent)
             throw std::runtime_error(SB()<<"Source already registered : ("<<name<<", "<<order<<")");
         ent = src;
+        pvt->sourceAdded(src);
         pvt->beaconChange++;
     }
     return *this;
@@ -109,6 +320,7 @@ std::shared_ptr<Source> Server::removeSource(const std::string& name,  int order
     if(it!=pvt->sources.end()) {
         ret = it->second;
         pvt->sources.erase(it);
+        pvt->sourceRemoved(ret);
     }
     pvt->beaconChange++;
 
@@ -240,39 +452,49 @@ Report Server::report(bool zero) const
 
     Report ret;
 
-    pvt->acceptor_loop.call([this, &ret, zero](){
+    for(auto& worker : pvt->workers) {
+        worker->loop.call([&worker, &ret, zero](){
 
-        for(auto& pair : pvt->connections) {
-            auto conn = pair.first;
+            ret.workers.emplace_back();
+            auto& sworker = ret.workers.back();
+            sworker.name = worker->name;
+            sworker.connections = worker->connections.size();
 
-            ret.connections.emplace_back();
-            auto& sconn = ret.connections.back();
-            sconn.peer = conn->peerName;
-            sconn.credentials = conn->cred;
-            sconn.tx = conn->statTx;
-            sconn.rx = conn->statRx;
-
-            if(zero) {
-                conn->statTx = conn->statRx = 0u;
-            }
+            for(auto& pair : worker->connections) {
+                auto conn = pair.first;
 
-            for(auto& pair : conn->chanBySID) {
-                auto& chan = pair.second;
+                ret.connections.emplace_back();
+                auto& sconn = ret.connections.back();
+                sconn.peer = conn->peerName;
+                sconn.credentials = conn->cred;
+                sconn.tx = conn->statTx;
+                sconn.rx = conn->statRx;
 
-                sconn.channels.emplace_back();
-                auto& schan = sconn.channels.back();
-                schan.name = chan->name;
-                schan.tx = chan->statTx;
-                schan.rx = chan->statRx;
-                schan.info = chan->reportInfo;
+                sworker.tx += conn->statTx;
+                sworker.rx += conn->statRx;
 
                 if(zero) {
-                    chan->statTx = chan->statRx = 0u;
+                    conn->statTx = conn->statRx = 0u;
+                }
+
+                for(auto& pair : conn->chanBySID) {
+                    auto& chan = pair.second;
+
+                    sconn.channels.emplace_back();
+                    auto& schan = sconn.channels.back();
+                    schan.name = chan->name;
+                    schan.tx = chan->statTx;
+                    schan.rx = chan->statRx;
+                    schan.info = chan->reportInfo;
+
+                    if(zero) {
+                        chan->statTx = chan->statRx = 0u;
+                    }
                 }
             }
-        }
 
-    });
+        });
+    }
 
     return ret;
 }
@@ -322,57 +544,66 @@ std::ostream& operator<<(std::ostream& strm, const Server& serv)
                 strm<<" TCP_Port: "<<first.bind_addr.port();
             }
             strm<<"\n";
+        });
 
-            Indented I(strm);
+        Indented I(strm);
 
-            for(auto& pair : serv.pvt->connections) {
-                auto conn = pair.first;
+        for(auto& worker : serv.pvt->workers) {
+            worker->loop.call([&worker, &strm, detail](){
+                strm<<indent{}<<"Worker "<<worker->name
+                    <<" connections="<<worker->connections.size()<<"\n";
 
-                strm<<indent{}<<"Peer"<<conn->peerName
-                    <<" backlog="<<conn->backlog.size()
-                    <<" TX="<<conn->statTx<<" RX="<<conn->statRx
-                    <<" auth="<<conn->cred->method<<"\n";
-                if(detail>2)
-                    strm<<*conn->cred;
+                Indented I(strm);
 
-                if(detail<=2)
-                    continue;
+                for(auto& pair : worker->connections) {
+                    auto conn = pair.first;
 
-                Indented I(strm);
+                    strm<<indent{}<<"Peer"<<conn->peerName
+                        <<" backlog="<<conn->backlog.size()
+                        <<" TX="<<conn->statTx<<" RX="<<conn->statRx
+                        <<" auth="<<conn->cred->method<<"\n";
+                    if(detail>2)
+                        strm<<*conn->cred;
 
-                for(auto& pair : conn->chanBySID) {
-                    auto& chan = pair.second;
-                    strm<<indent{}<<chan->name<<" TX="<<chan->statTx<<" RX="<<chan->statRx<<' ';
-
-                    if(chan->state==ServerChan::Creating) {
-                        strm<<"CREATING sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
-                    } else if(chan->state==ServerChan::Destroy) {
-                        strm<<"DESTROY  sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
-                    } else if(chan->opByIOID.empty()) {
-                        strm<<"IDLE     sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
-                    }
+                    if(detail<=2)
+                        continue;
+
+                    Indented I(strm);
+
+                    for(auto& pair : conn->chanBySID) {
+                        auto& chan = pair.second;
+                        strm<<indent{}<<chan->name<<" TX="<<chan->statTx<<" RX="<<chan->statRx<<' ';
+
+                        if(chan->state==ServerChan::Creating) {
+                            strm<<"CREATING sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
+                        } else if(chan->state==ServerChan::Destroy) {
+                            strm<<"DESTROY  sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
+                        } else if(chan->opByIOID.empty()) {
+                            strm<<"IDLE     sid="<<chan->sid<<" cid="<<chan->cid<<"\n";
+                        }
 
-                    for(auto& pair : chan->opByIOID) {
-                        auto& op = pair.second;
-                        if(!op) {
-                            strm<<"NULL ioid="<<pair.first<<"\n";
-                        } else {
-                            strm<<indent{};
-                            switch (op->state) {
+                        for(auto& pair : chan->opByIOID) {
+                            auto& op = pair.second;
+                            if(!op) {
+                                strm<<"NULL ioid="<<pair.first<<"\n";
+                            } else {
+                                strm<<indent{};
+                                switch (op->state) {
 #define CASE(STATE) case ServerOp::STATE: strm<< #STATE; break
-                            CASE(Creating);
-                            CASE(Idle);
-                            CASE(Executing);
-                            CASE(Dead);
+                                CASE(Creating);
+                                CASE(Idle);
+                                CASE(Executing);
+                                CASE(Dead);
 #undef CASE
+                                }
+                                strm<<" ioid="<<pair.first<<" ";
+                                op->show(strm);
                             }
-                            strm<<" ioid="<<pair.first<<" ";
-                            op->show(strm);
                         }
                     }
                 }
-            }
-        });
+            });
+        }
     }
 
     return strm;
@@ -388,10 +619,23 @@ Server::Pvt::Pvt(const Config &conf)
                  event_new(acceptor_loop.base, -1, EV_TIMEOUT, doBeaconsS, this))
     ,searchReply(0x10000)
     ,builtinsrc(StaticSource::build())
+    ,searchIndex(std::make_shared<SearchIndex>())
     ,state(Stopped)
 {
     effective.expand();
 
+    if(effective.nWorkers==0u) {
+        // connections serviced by the accepting thread
+        workers.emplace_back(new ServerWorker("PVXTCP", acceptor_loop.internal()));
+
+    } else {
+        workers.reserve(effective.nWorkers);
+        for(auto i : range(effective.nWorkers)) {
+            std::string name(SB()<<"PVXTCP-"<<i);
+            workers.emplace_back(new ServerWorker(name, evbase(name, epicsThreadPriorityCAServerLow-2)));
+        }
+    }
+
     beaconSender4.set_broadcast(true);
 
     auto manager = UDPManager::instance(effective.shareUDP());
@@ -558,8 +802,11 @@ Server::Pvt::Pvt(const Config &conf)
     // Add magic "server" PV
     {
         auto L = sourcesLock.lockWriter();
-        sources[std::make_pair(-1, "__server")] = std::make_shared<ServerSource>(this);
+        auto server(std::make_shared<ServerSource>(this));
+        sources[std::make_pair(-1, "__server")] = server;
+        sourceAdded(server);
         sources[std::make_pair(-1, "__builtin")] = builtinsrc.source();
+        sourceAdded(builtinsrc.source());
     }
 }
 
@@ -650,23 +897,102 @@ void Server::Pvt::stop()
             log_debug_printf(serversetup, "Server disabled listener on %s\n", iface.name.c_str());
         }
 
-        // close current TCP connections
-        auto conns = std::move(connections);
-        for(auto& pair : conns) {
-            pair.second->disconnect();
-            pair.second->cleanup();
-        }
-
         state = Stopped;
     });
 
+    // close current TCP connections.
+    // any connection setup dispatch()'d by onConnS() is ordered before this
+    for(auto& worker : workers) {
+        worker->loop.call([&worker]()
+        {
+            auto conns = std::move(worker->connections);
+            worker->load -= conns.size();
+            for(auto& pair : conns) {
+                pair.second->disconnect();
+                pair.second->cleanup();
+            }
+        });
+    }
+
     /* Cycle through once more to ensure any callbacks queue during the previous call have completed.
      * TODO: this is partly a crutch as eg. SharedPV::attach() binds strong self references
      *       into on*() lambdas, which indirectly hold references keeping acceptor_loop alive.
      */
+    for(auto& worker : workers) {
+        worker->loop.sync();
+    }
     acceptor_loop.sync();
 }
 
+ServerWorker* Server::Pvt::pickWorker()
+{
+    // least loaded, with ties broken round-robin
+    auto N = workers.size();
+    auto best = nextWorker%N;
+    auto bestLoad = workers[best]->load.load();
+
+    for(auto i : range(size_t(1u), N)) {
+        auto idx = (nextWorker+i)%N;
+        auto load = workers[idx]->load.load();
+        if(load < bestLoad) {
+            best = idx;
+            bestLoad = load;
+        }
+    }
+
+    nextWorker = best+1u;
+    workers[best]->load++;
+    return workers[best].get();
+}
+
+static
+void collectSearchSources(Server::Pvt* pvt)
+{
+    pvt->searchSources.clear();
+    for(const auto& pair : pvt->sources) {
+        if(!dynamic_cast<IndexedSource*>(pair.second.get()))
+            pvt->searchSources.emplace_back(pair.first.second, pair.second);
+    }
+}
+
+void Server::Pvt::sourceAdded(const std::shared_ptr<Source>& src)
+{
+    if(auto isrc = dynamic_cast<IndexedSource*>(src.get())) {
+        isrc->attachIndex(searchIndex);
+    } else {
+        collectSearchSources(this);
+        searchIndex->invalidate();
+    }
+}
+
+void Server::Pvt::sourceRemoved(const std::shared_ptr<Source>& src)
+{
+    if(auto isrc = dynamic_cast<IndexedSource*>(src.get())) {
+        isrc->detachIndex(searchIndex);
+    } else {
+        collectSearchSources(this);
+        searchIndex->invalidate();
+    }
+}
+
+void Server::Pvt::doSearch(Source::Search& op)
+{
+    for(auto& name : op._names) {
+        if(searchIndex->contains(name._name))
+            name._claim = true;
+    }
+
+    auto G(sourcesLock.lockReader());
+    for(const auto& pair : searchSources) {
+        try {
+            pair.second->onSearch(op);
+        }catch(std::exception& e){
+            log_exc_printf(serversetup, "Unhandled error in Source::onSearch for '%s' : %s\n",
+                       pair.first.c_str(), e.what());
+        }
+    }
+}
+
 void Server::Pvt::onSearch(const UDPManager::Search& msg)
 {
     // on UDPManager worker
@@ -685,6 +1011,19 @@ void Server::Pvt::onSearch(const UDPManager::Search& msg)
         }
     }
 
+    epicsTimeStamp now{};
+    const double cacheTmo = effective.searchCacheTimeout;
+    if(effective.searchRate>0.0 || cacheTmo>0.0)
+        epicsTimeGetCurrent(&now);
+
+    if(effective.searchRate>0.0) {
+        // allow one second worth of searches to arrive at once
+        if(!searchLimit.allow(msg.src, now, effective.searchRate, std::max(1.0, effective.searchRate))) {
+            log_debug_printf(serverio, "%s search rate limited\n", msg.src.tostring().c_str());
+            return;
+        }
+    }
+
     log_debug_printf(serverio, "%s searching\n", msg.src.tostring().c_str());
 
     searchOp._names.resize(msg.names.size());
@@ -694,14 +1033,39 @@ void Server::Pvt::onSearch(const UDPManager::Search& msg)
     }
     ipAddrToDottedIP(&msg.server->in, searchOp._src, sizeof(searchOp._src));
 
-    {
-        auto G(sourcesLock.lockReader());
-        for(const auto& pair : sources) {
-            try {
-                pair.second->onSearch(searchOp);
-            }catch(std::exception& e){
-                log_exc_printf(serversetup, "Unhandled error in Source::onSearch for '%s' : %s\n",
-                           pair.first.second.c_str(), e.what());
+    if(cacheTmo<=0.0) {
+        doSearch(searchOp);
+
+    } else {
+        // read before doSearch().  A concurrent change will clear entries which it inserts.
+        auto changes = searchIndex->changes();
+        if(changes!=negCacheChanges) {
+            negCache.clear();
+            negCacheChanges = changes;
+        }
+
+        // only ask about names which no Source has recently declined to claim
+        searchTodo._names.clear();
+        for(auto& name : searchOp._names) {
+            if(!negCache.contains(name._name, now, cacheTmo))
+                searchTodo._names.push_back(name);
+        }
+
+        if(!searchTodo._names.empty()) {
+            memcpy(searchTodo._src, searchOp._src, sizeof(searchOp._src));
+            doSearch(searchTodo);
+
+            // searchTodo._names is an ordered subset of searchOp._names
+            auto todo = searchTodo._names.begin();
+            for(auto& name : searchOp._names) {
+                if(todo==searchTodo._names.end())
+                    break;
+                if(todo->_name!=name._name)
+                    continue;
+                name._claim = todo->_claim;
+                if(!name._claim)
+                    negCache.insert(name._name, now, cacheTmo);
+                ++todo;
             }
         }
     }
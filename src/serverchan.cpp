@@ -63,6 +63,7 @@ ServerChannelControl::ServerChannelControl(const std::shared_ptr<ServerConn> &co
     :server::ChannelControl(channel->name, conn->cred, None)
     ,server(conn->iface->server->internal_self)
     ,chan(channel)
+    ,loop(conn->worker->loop.internal())
 {}
 
 ServerChannelControl::~ServerChannelControl() {}
@@ -73,7 +74,7 @@ void ServerChannelControl::onOp(std::function<void(std::unique_ptr<server::Conne
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.call([this, &fn](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -88,7 +89,7 @@ void ServerChannelControl::onRPC(std::function<void(std::unique_ptr<server::Exec
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.call([this, &fn](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -103,7 +104,7 @@ void ServerChannelControl::onSubscribe(std::function<void(std::unique_ptr<server
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.call([this, &fn](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -118,7 +119,7 @@ void ServerChannelControl::onClose(std::function<void(const std::string&)>&& fn)
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.call([this, &fn](){
         auto ch = chan.lock();
         if(!ch || ch->state==ServerChan::Destroy)
             return;
@@ -134,7 +135,7 @@ void ServerChannelControl::close()
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this](){
+    loop.call([this](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -162,7 +163,7 @@ void ServerChannelControl::_updateInfo(const std::shared_ptr<const ReportInfo>&
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &info](){
+    loop.call([this, &info](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -209,17 +210,7 @@ void ServerConn::handle_SEARCH()
     if(!M.good())
         throw std::runtime_error(SB()<<M.file()<<':'<<M.line()<<" TCP Search decode error");
 
-    {
-        auto G(iface->server->sourcesLock.lockReader());
-        for(const auto& pair : iface->server->sources) {
-            try {
-                pair.second->onSearch(op);
-            }catch(std::exception& e){
-                log_exc_printf(serversearch, "Unhandled error in Source::onSearch for '%s' : %s\n",
-                           pair.first.second.c_str(), e.what());
-            }
-        }
-    }
+    iface->server->doSearch(op);
 
     uint16_t nreply = 0;
     for(const auto& name : op._names) {
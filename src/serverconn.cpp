@@ -53,15 +53,16 @@ DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
 DEFINE_LOGGER(remote, "pvxs.remote.log");
 
-ServerConn::ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *peer, int socklen)
+ServerConn::ServerConn(ServIface* iface, ServerWorker* worker, evutil_socket_t sock, const SockAddr& peer)
     :ConnBase(false, iface->server->effective.sendBE(),
-              bufferevent_socket_new(iface->server->acceptor_loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS),
-              SockAddr(peer))
+              bufferevent_socket_new(worker->loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS),
+              peer)
     ,iface(iface)
+    ,worker(worker)
     ,tcp_tx_limit(evsocket::get_buffer_size(sock, true) * tcp_tx_limit_mult)
 {
-    log_debug_printf(connio, "Client %s connects, RX readahead %zu TX limit %zu\n",
-                     peerName.c_str(), readahead, tcp_tx_limit);
+    log_debug_printf(connio, "Client %s connects on %s, RX readahead %zu TX limit %zu\n",
+                     peerName.c_str(), worker->name.c_str(), readahead, tcp_tx_limit);
     {
         int opt = 1;
         if(setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&opt, sizeof(opt))<0) {
@@ -347,7 +348,8 @@ void ServerConn::cleanup()
 {
     log_debug_printf(connsetup, "Client %s Cleanup TCP Connection\n", peerName.c_str());
 
-    iface->server->connections.erase(this);
+    if(worker->connections.erase(this))
+        worker->load--;
 
     // grab maps before cleanup()s would modify
     auto ops(std::move(opByIOID));
@@ -465,11 +467,26 @@ ServIface::ServIface(const SockAddr &addr, server::Server::Pvt *server, bool fal
 void ServIface::onConnS(struct evconnlistener *listener, evutil_socket_t sock, struct sockaddr *peer, int socklen, void *raw)
 {
     auto self = static_cast<ServIface*>(raw);
+    ServerWorker* worker = nullptr;
     try {
-        auto conn(std::make_shared<ServerConn>(self, sock, peer, socklen));
-        self->server->connections[conn.get()] = std::move(conn);
+        worker = self->server->pickWorker();
+        SockAddr addr(peer);
+
+        // complete setup on the worker which will service this connection
+        worker->loop.dispatch([self, worker, sock, addr]() {
+            try {
+                auto conn(std::make_shared<ServerConn>(self, worker, sock, addr));
+                worker->connections[conn.get()] = std::move(conn);
+            }catch(std::exception& e){
+                log_exc_printf(connsetup, "Interface %s Unhandled error in connection setup: %s\n", self->name.c_str(), e.what());
+                worker->load--;
+                evutil_closesocket(sock);
+            }
+        });
     }catch(std::exception& e){
         log_exc_printf(connsetup, "Interface %s Unhandled error in accept callback: %s\n", self->name.c_str(), e.what());
+        if(worker)
+            worker->load--;
         evutil_closesocket(sock);
     }
 }
@@ -511,7 +528,7 @@ void ServerOp::cleanup()
             conn->opByIOID.erase(ioid);
 
             if(notify) {
-                conn->iface->server->acceptor_loop.dispatch([closer](){
+                conn->worker->loop.dispatch([closer](){
                     closer("");
                 });
                 notify = false;
@@ -9,10 +9,13 @@
 
 #include <list>
 #include <map>
+#include <set>
+#include <unordered_map>
 #include <memory>
 #include <atomic>
 
 #include <epicsEvent.h>
+#include <epicsTime.h>
 
 #include <pvxs/server.h>
 #include <pvxs/source.h>
@@ -28,6 +31,7 @@ namespace pvxs {namespace impl {
 struct ServIface;
 struct ServerConn;
 struct ServerChan;
+struct ServerWorker;
 
 // base for tracking in-progress operations.  cf. ServerConn::opByIOID and ServerChan::opByIOID
 struct ServerOp
@@ -57,6 +61,206 @@ struct ServerOp
     virtual void show(std::ostream& strm) const =0;
 };
 
+/* Log of the updates posted to one SharedPV, shared by all of its subscriptions.
+ *
+ * Each subscription attach()es as a Reader, with a read cursor (a sequence number)
+ * in place of a private queue.  Entries are immutable snapshots, so subscribers also
+ * share encodings.  An entry is released once every Reader has passed it.
+ * The ring holds at most as many entries as the largest limit of any Reader.
+ * A Reader which has fallen more than its limit behind reads the oldest part
+ * of its backlog merged into a single update.
+ */
+struct PVXS_API UpdateRing {
+    struct Reader {
+        virtual ~Reader() {}
+        // called, without locks held, by the first push() after waitFor() returned true
+        virtual void wakeup() =0;
+    };
+
+    static constexpr size_t maxDepth = 1024u;
+
+    UpdateRing();
+
+    // reader will read entries from the next push(), and may fall up to limit entries behind.
+    void attach(const std::shared_ptr<Reader>& reader, size_t limit);
+    // Forget reader.  Releases entries which only it had yet to read.
+    void detach(const Reader* reader);
+
+    // append a snapshot of val, and wake waiting Readers.  Returns the snapshot.
+    Value push(const Value& val);
+
+    // sequence number of the next push()
+    uint64_t head() const;
+
+    // number of entries which reader would pop() before end
+    size_t pending(const Reader* reader, uint64_t end) const;
+
+    /* Take the next update for reader, from entries before end.
+     * When more than its limit remain, or some have already left the ring,
+     * the oldest are merged so that limit remain, and nsquash is incremented.
+     * Returns an empty Value when none remain.
+     */
+    Value pop(const Reader* reader, uint64_t end, size_t& nsquash);
+
+    // Register reader to be woken by the next push().  Returns false,
+    // without registering, if entries are already available to reader.
+    bool waitFor(const Reader* reader);
+
+    // number of entries retained, and the most which may be retained
+    size_t size() const;
+    size_t depth() const;
+
+private:
+    struct ReaderInfo {
+        std::weak_ptr<Reader> reader;
+        uint64_t cursor;
+        size_t limit;
+    };
+
+    mutable epicsMutex lock;
+    SnapshotPool snapshots;
+    // entry with sequence number s is at entries[s%entries.size()]
+    std::vector<Value> entries;
+    // sequence numbers of the oldest entry retained, and of the next push()
+    uint64_t first = 0u, next = 0u;
+    // merge of entries which have left the ring before some Reader read them
+    Value dropped;
+    std::map<const Reader*, ReaderInfo> readers;
+    // of all readers
+    std::multiset<uint64_t> cursors;
+    std::multiset<size_t> limits;
+    std::vector<std::weak_ptr<Reader>> waiting;
+
+    // caller must hold lock
+    void evict();
+    void release();
+    void resize();
+};
+
+// Subscription sub, from connect() of this server, will also send updates pushed
+// to ring after this call.  Returns false if sub is not from this server.
+bool attachRing(const std::shared_ptr<server::MonitorControlOp>& sub,
+                const std::shared_ptr<UpdateRing>& ring);
+
+// for maps keyed by an already computed hash
+struct IdentityHash {
+    size_t operator()(uint64_t h) const { return size_t(h); }
+};
+
+/* Server wide set of the PV names which IndexedSource instances will claim.
+ *
+ * Names are kept in a hash table divided into shards, each with its own lock.
+ * In front is a counting bloom filter, which rejects most absent names
+ * without touching any shard.
+ */
+struct PVXS_API SearchIndex {
+    static constexpr size_t nshards = 16u;
+
+    SearchIndex();
+    ~SearchIndex();
+
+    // add one reference to name
+    void add(const std::string& name);
+    // remove one reference to name
+    void remove(const std::string& name);
+    // true if name has more add() than remove()
+    bool contains(const char* name) const;
+    // number of distinct names
+    size_t size() const;
+
+    // incremented by each add() and remove() which changes the set of names, and by invalidate()
+    size_t changes() const { return nchanges.load(); }
+    // the names claimed by some Source, not in this index, may have changed
+    void invalidate() { nchanges++; }
+
+    static uint64_t hash(const char* name);
+
+private:
+    struct Entry {
+        std::string name;
+        size_t refs;
+    };
+    struct Shard {
+        mutable epicsMutex lock;
+        std::unordered_multimap<uint64_t, Entry, IdentityHash> names;
+    };
+    Shard shards[nshards];
+
+    // serialize add() and remove()
+    mutable epicsMutex writeLock;
+    size_t nnames = 0u;
+    std::atomic<size_t> nchanges{0u};
+
+    mutable RWLock bloomLock;
+    // saturating counters.  size is a power of 2.
+    std::vector<uint8_t> bloom;
+
+    // top bits select shard, bottom bits select bloom counters
+    Shard& shardOf(uint64_t h) { return shards[h>>60u]; }
+    const Shard& shardOf(uint64_t h) const { return shards[h>>60u]; }
+    void bloomAdjust(uint64_t h, bool inc);
+    void bloomRebuild(size_t nbuckets);
+};
+
+/* Names recently searched for, which no Source claimed.
+ *
+ * Not thread safe.  Entries expire after a caller provided timeout.
+ */
+struct PVXS_API NegativeSearchCache {
+    // arbitrary sanity limit
+    static constexpr size_t limit = 65536u;
+
+    // true if name was insert()ed less than tmo seconds before now
+    bool contains(const char* name, const epicsTimeStamp& now, double tmo) const;
+    // If full, first drop entries more than tmo seconds old, then all entries.
+    void insert(const char* name, const epicsTimeStamp& now, double tmo);
+    void clear() { entries.clear(); }
+    size_t size() const { return entries.size(); }
+
+private:
+    struct Entry {
+        std::string name;
+        epicsTimeStamp added;
+    };
+    // keyed by SearchIndex::hash()
+    std::unordered_multimap<uint64_t, Entry, IdentityHash> entries;
+};
+
+/* Token bucket for each client IP address, limiting the rate of
+ * search requests from that address.
+ *
+ * Not thread safe.
+ */
+struct PVXS_API SearchRateLimit {
+    // arbitrary sanity limit
+    static constexpr size_t limit = 4096u;
+
+    // Take a token from the bucket of peer, which holds up to burst tokens, and is
+    // refilled at rate tokens per second.  Returns false if the bucket is empty.
+    bool allow(const SockAddr& peer, const epicsTimeStamp& now, double rate, double burst);
+    size_t size() const { return buckets.size(); }
+
+private:
+    struct Bucket {
+        double tokens;
+        epicsTimeStamp last;
+    };
+    std::map<SockAddr, Bucket, SockAddrOnlyLess> buckets;
+};
+
+/* Implemented by a Source whose onSearch() claims exactly those names
+ * which it add()s to the SearchIndex of each Server it has been added to.
+ * Such Sources are never asked to onSearch() by a Server, which instead
+ * consults its SearchIndex.
+ */
+struct IndexedSource {
+    virtual ~IndexedSource() {}
+    // add() all current names to idx, and keep idx updated until detachIndex()
+    virtual void attachIndex(const std::shared_ptr<SearchIndex>& idx) =0;
+    // remove() all current names from idx
+    virtual void detachIndex(const std::shared_ptr<SearchIndex>& idx) =0;
+};
+
 struct ServerChannelControl : public server::ChannelControl
 {
     ServerChannelControl(const std::shared_ptr<ServerConn>& conn, const std::shared_ptr<ServerChan>& chan);
@@ -73,6 +277,8 @@ struct ServerChannelControl : public server::ChannelControl
 
     const std::weak_ptr<server::Server::Pvt> server;
     const std::weak_ptr<ServerChan> chan;
+    // worker of owning ServerConn
+    const evbase loop;
 
     INST_COUNTER(ServerChannelControl);
 };
@@ -113,6 +319,7 @@ struct ServerChan
 struct ServerConn final : public ConnBase, public std::enable_shared_from_this<ServerConn>
 {
     ServIface* const iface;
+    ServerWorker* const worker;
     const size_t tcp_tx_limit;
 
     std::shared_ptr<const server::ClientCredentials> cred;
@@ -125,7 +332,7 @@ struct ServerConn final : public ConnBase, public std::enable_shared_from_this<S
 
     INST_COUNTER(ServerConn);
 
-    ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *peer, int socklen);
+    ServerConn(ServIface* iface, ServerWorker* worker, evutil_socket_t sock, const SockAddr& peer);
     ServerConn(const ServerConn&) = delete;
     ServerConn& operator=(const ServerConn&) = delete;
     ~ServerConn();
@@ -181,8 +388,24 @@ struct ServIface
 };
 
 
+//! A thread servicing some of the accepted TCP connections
+struct ServerWorker
+{
+    const std::string name;
+    evbase loop;
+
+    // only access from loop worker
+    std::map<ServerConn*, std::shared_ptr<ServerConn> > connections;
+
+    // number of connections assigned, including those not yet constructed.
+    // incremented by acceptor, decremented by worker.
+    std::atomic<size_t> load{0u};
+
+    ServerWorker(const std::string& name, const evbase& loop) :name(name), loop(loop) {}
+};
+
 //! Home of the magic "server" PV used by "pvinfo"
-struct ServerSource : public server::Source
+struct ServerSource : public server::Source, public IndexedSource
 {
     const std::string name;
     server::Server::Pvt* const serv;
@@ -196,6 +419,10 @@ struct ServerSource : public server::Source
     virtual void onSearch(Search &op) override final;
 
     virtual void onCreate(std::unique_ptr<server::ChannelControl> &&op) override final;
+
+    // our "server" PV is not advertised.  So nothing to index.
+    virtual void attachIndex(const std::shared_ptr<SearchIndex>& idx) override final {}
+    virtual void detachIndex(const std::shared_ptr<SearchIndex>& idx) override final {}
 };
 
 } // namespace impl
@@ -223,12 +450,17 @@ struct Server::Pvt
     // accept new connections and send beacons
     evbase acceptor_loop;
 
+    // service TCP connections.  When effective.nWorkers==0, a single
+    // entry which shares acceptor_loop.
+    std::vector<std::unique_ptr<ServerWorker> > workers;
+    // only access from acceptor_loop
+    size_t nextWorker = 0u;
+
     std::list<std::unique_ptr<UDPListener> > listeners;
     std::vector<SockEndpoint> beaconDest;
     std::vector<SockAddr> ignoreList;
 
     std::list<ServIface> interfaces;
-    std::map<ServerConn*, std::shared_ptr<ServerConn> > connections;
 
     evsocket beaconSender4, beaconSender6;
     evevent beaconTimer;
@@ -238,11 +470,22 @@ struct Server::Pvt
     // properly a local of Pvt::onSearch() on the UDP worker.
     // made a member to avoid re-alloc of _names vector.
     Source::Search searchOp;
+    // the names from searchOp not found in negCache
+    Source::Search searchTodo;
+    // only used from the UDP worker
+    NegativeSearchCache negCache;
+    // searchIndex->changes() when negCache was last cleared
+    size_t negCacheChanges = 0u;
+    SearchRateLimit searchLimit;
 
     StaticSource builtinsrc;
 
     RWLock sourcesLock;
     std::map<std::pair<int, std::string>, std::shared_ptr<Source> > sources;
+    // names claimed by those of sources which are IndexedSource
+    const std::shared_ptr<SearchIndex> searchIndex;
+    // the remainder of sources, which doSearch() must ask.  Guarded by sourcesLock
+    std::vector<std::pair<std::string, std::shared_ptr<Source>>> searchSources;
 
     enum state_t {
         Stopped,
@@ -259,6 +502,16 @@ struct Server::Pvt
     void start();
     void stop();
 
+    // on acceptor_loop.  select worker for a new connection
+    ServerWorker* pickWorker();
+
+    // with sourcesLock held for write
+    void sourceAdded(const std::shared_ptr<Source>& src);
+    void sourceRemoved(const std::shared_ptr<Source>& src);
+
+    // claim names of op through searchIndex, and ask other Sources.
+    void doSearch(Source::Search& op);
+
 private:
     void onSearch(const UDPManager::Search& msg);
     void doBeacons(short evt);
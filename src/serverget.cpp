@@ -100,7 +100,7 @@ struct ServerGPR final : public ServerOp
 
             } else if(state==Executing) {
                 if(cmd==CMD_GET || (cmd==CMD_PUT && (subcmd&0x40))) {
-                    to_wire_valid(R, value, &pvMask); // GET and PUT/Get reply with bitmask and partial value
+                    to_wire_valid(R, value, plan); // GET and PUT/Get reply with bitmask and partial value
 
                 } else if(cmd==CMD_RPC) {
                     auto type = Value::Helper::desc(value);
@@ -151,7 +151,7 @@ struct ServerGPR final : public ServerOp
 
     std::shared_ptr<const FieldDesc> type;
     Value pvRequest;
-    BitMask pvMask; // mask computed from pvRequest .fields
+    EncodePlan plan; // from type and mask computed from pvRequest .fields
 
     std::function<void(std::unique_ptr<server::ExecOp>&&, Value&&)> onPut;
 
@@ -173,6 +173,7 @@ struct ServerGPRConnect : public server::ConnectOp
         :server::ConnectOp(name, conn->cred, cmd2op(cmd), request)
         ,server(server)
         ,op(op)
+        ,loop(conn->worker->loop.internal())
     {}
     virtual ~ServerGPRConnect() {
         error("Op Create implied error");
@@ -183,7 +184,7 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &prototype](){
+        loop.call([this, &prototype](){
             if(auto oper = op.lock()) {
                 if(oper->state!=ServerOp::Creating)
                     return;
@@ -196,7 +197,7 @@ struct ServerGPRConnect : public server::ConnectOp
 
                 if(prototype) {
                     oper->type = Value::Helper::type(prototype);
-                    oper->pvMask = request2mask(oper->type.get(), _pvRequest);
+                    oper->plan = EncodePlan(oper->type, request2mask(oper->type.get(), _pvRequest));
                 }
 
                 oper->doReply(Value(), std::string());
@@ -211,7 +212,7 @@ struct ServerGPRConnect : public server::ConnectOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg](){
+        loop.dispatch([op, msg](){
             if(auto oper = op.lock()) {
                 if(oper->state==ServerOp::Creating)
                     oper->doReply(Value(), msg);
@@ -224,7 +225,7 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onGet = std::move(fn);
         });
@@ -234,7 +235,7 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onPut = std::move(fn);
         });
@@ -244,7 +245,7 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onClose = std::move(fn);
         });
@@ -252,6 +253,7 @@ struct ServerGPRConnect : public server::ConnectOp
 
     const std::weak_ptr<server::Server::Pvt> server;
     const std::weak_ptr<ServerGPR> op;
+    const evbase loop;
 
     INST_COUNTER(ServerGPRConnect);
 };
@@ -268,6 +270,7 @@ struct ServerGPRExec : public server::ExecOp
         :server::ExecOp(name, conn->cred, cmd2op(cmd), op->pvRequest)
         ,server(server)
         ,op(op)
+        ,loop(conn->worker->loop.internal())
     {}
     virtual ~ServerGPRExec() {}
 
@@ -282,7 +285,7 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, val](){
+        loop.dispatch([op, val](){
             if(auto oper = op.lock()) {
                 oper->doReply(val, std::string());
             }
@@ -297,7 +300,7 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg](){
+        loop.dispatch([op, msg](){
             if(auto oper = op.lock()) {
                 oper->doReply(Value(), msg);
             }
@@ -309,7 +312,7 @@ struct ServerGPRExec : public server::ExecOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onCancel = std::move(fn);
         });
@@ -321,11 +324,12 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             throw std::logic_error("Can't start timer on deal server");
 
-        return Timer::Pvt::buildOneShot(delay, serv->acceptor_loop.internal(), std::move(fn));
+        return Timer::Pvt::buildOneShot(delay, loop, std::move(fn));
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
     const std::weak_ptr<ServerGPR> op;
+    const evbase loop;
 
     INST_COUNTER(ServerGPRExec);
 };
@@ -66,6 +66,7 @@ struct ServerIntrospectControl : public server::ConnectOp
         :server::ConnectOp(chan->name, conn->cred, Info, Value()) // TODO: pvRequest?
         ,server(server)
         ,op(op)
+        ,loop(conn->worker->loop.internal())
     {}
     virtual ~ServerIntrospectControl() {
         error("Implicit Cancel");
@@ -92,7 +93,7 @@ struct ServerIntrospectControl : public server::ConnectOp
         if(!serv)
             return; // soft fail if already completed, canceled, disconnected, ....
 
-        serv->acceptor_loop.call([this, type, &sts](){
+        loop.call([this, type, &sts](){
             if(auto oper = op.lock())
                 oper->doReply(type, sts);
         });
@@ -103,7 +104,7 @@ struct ServerIntrospectControl : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onClose = std::move(fn);
         });
@@ -115,6 +116,7 @@ struct ServerIntrospectControl : public server::ConnectOp
 
     const std::weak_ptr<server::Server::Pvt> server;
     const std::weak_ptr<ServerIntrospect> op;
+    const evbase loop;
 
     INST_COUNTER(ServerIntrospectControl);
 };
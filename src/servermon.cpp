@@ -39,9 +39,12 @@ struct MonitorOp final : public ServerOp
             }
         };
     }
-    virtual ~MonitorOp() {}
+    virtual ~MonitorOp() {
+        if(ring)
+            ring->detach(reader);
+    }
 
-    // only access from accepter worker thread
+    // only access from connection worker thread
     std::function<void(bool)> onStart;
     std::function<void()> onLowMark;
     std::function<void()> onHighMark;
@@ -50,7 +53,7 @@ struct MonitorOp final : public ServerOp
 
     // const after setup phase
     std::shared_ptr<const FieldDesc> type;
-    BitMask pvMask;
+    EncodePlan plan; // from type and mask computed from pvRequest .fields
     std::string msg;
 
     // Further members guarded by this lock (except as noted)
@@ -69,18 +72,77 @@ struct MonitorOp final : public ServerOp
 
     std::deque<Value> queue;
 
+    // when attached to a SharedPV, updates are also read from ring.
+    // queue entries, other than finish(), are sent first.
+    std::shared_ptr<UpdateRing> ring;
+    const UpdateRing::Reader* reader=nullptr;
+    uint64_t ringEnd=0u; // once finished, ring entries from later post()s are ignored
+    bool ringWaiting=false;
+
     INST_COUNTER(MonitorOp);
 
+    // caller must hold lock.
+    size_t ringPending() const {
+        return ring ? ring->pending(reader, finished ? ringEnd : uint64_t(-1)) : 0u;
+    }
+
+    // caller must hold lock.
+    // no more updates will be read from ring
+    void detachRing() {
+        if(ring) {
+            ring->detach(reader);
+            ring.reset();
+            reader = nullptr;
+        }
+    }
+
+    // caller must hold lock.
+    bool pending() const {
+        return !queue.empty() || ringPending();
+    }
+
+    // caller must hold lock.
+    // Next update to send, or empty if none (including if finish() is next)
+    Value nextUpdate()
+    {
+        if(!queue.empty() && queue.front()) {
+            auto ret(std::move(queue.front()));
+            queue.pop_front();
+            return ret;
+        }
+
+        while(ring) {
+            auto ret(ring->pop(reader, finished ? ringEnd : uint64_t(-1), nSquash));
+            if(!ret) {
+                if(finished) {
+                    detachRing();
+                    break;
+                }
+                if(ringWaiting)
+                    break;
+                ringWaiting = ring->waitFor(reader);
+                if(ringWaiting)
+                    break;
+                continue; // raced with push()
+
+            } else if(testmask(ret, plan.mask)) {
+                return ret;
+            }
+            // skip update which changes none of the fields requested
+        }
+        return Value();
+    }
+
     // caller must hold lock.
     // only used after State==Idle
     static
-    void maybeReply(server::Server::Pvt* server, const std::shared_ptr<MonitorOp>& op)
+    void maybeReply(const evbase& loop, const std::shared_ptr<MonitorOp>& op)
     {
         // can we send a reply?
-        if(!op->scheduled && op->state==Executing && !op->queue.empty() && (!op->pipeline || op->window))
+        if(!op->scheduled && op->state==Executing && op->pending() && (!op->pipeline || op->window))
         {
             // based on operation state, yes
-            server->acceptor_loop.dispatch([op](){
+            loop.dispatch([op](){
                 auto ch(op->chan.lock());
                 if(!ch)
                     return;
@@ -126,21 +188,31 @@ struct MonitorOp final : public ServerOp
             return;
 
         uint8_t subcmd = 0u;
+        Value ent;
         if(self->state==Creating) {
             subcmd = 0x08;
             self->state = self->type ? Idle : Dead;
 
-        } else if(self->state==Executing) {
-            if(self->queue.empty() || (self->pipeline && !self->window && !self->finished)) {
-                log_debug_printf(connio, "Client %s IOID %u done reply\n",
+        } else {
+            if(self->state==Executing && self->pipeline && !self->window && !self->finished) {
+                log_debug_printf(connio, "Client %s IOID %u window closed\n",
                                  conn->peerName.c_str(), unsigned(self->ioid));
-                return; // nothing to do
+                return;
 
-            } else if(!self->queue.front()) {
+            } else if(!!(ent = self->nextUpdate())) {
+                // send update
+
+            } else if(!self->queue.empty()) { // finish (could be used to send an error)
+                self->queue.pop_front();
                 subcmd = 0x10;
                 self->state = Dead;
                 log_debug_printf(connio, "Client %s IOID %u finishes\n",
                                  conn->peerName.c_str(), unsigned(self->ioid));
+
+            } else {
+                log_debug_printf(connio, "Client %s IOID %u done reply\n",
+                                 conn->peerName.c_str(), unsigned(self->ioid));
+                return; // nothing to do
             }
         }
 
@@ -159,18 +231,13 @@ struct MonitorOp final : public ServerOp
                     to_wire(R, self->type.get());
                 }
 
-            } else if(!self->queue.empty()) {
-                auto& ent = self->queue.front();
-                if(ent) {
-                    to_wire_valid(R, ent, &self->pvMask);
-                    // TODO: placeholder for overrun mask
-                    to_wire(R, uint8_t(0u));
-
-                } else { // finish (could be used to send an error)
-                    to_wire(R, Status{});
-                }
+            } else if(subcmd&0x10) {
+                to_wire(R, Status{});
 
-                self->queue.pop_front();
+            } else {
+                to_wire_valid(R, ent, self->plan);
+                // TODO: placeholder for overrun mask
+                to_wire(R, uint8_t(0u));
             }
         }
 
@@ -187,7 +254,7 @@ struct MonitorOp final : public ServerOp
 
             if(!self->lowMarkPending && self->window <= self->low && self->onLowMark) {
                 self->lowMarkPending = true;
-                conn->iface->server->acceptor_loop.dispatch([self]() {
+                conn->worker->loop.dispatch([self]() {
                     decltype (self->onLowMark) fn;
                     {
                         Guard G(self->lock);
@@ -200,12 +267,18 @@ struct MonitorOp final : public ServerOp
             }
         }
 
-        if(self->state==Executing && !self->queue.empty()
+        if(self->state==Executing && self->ring && !self->finished && !self->ringWaiting && !self->pending()) {
+            // ring drained.  be woken by the next push().
+            // If this races with push(), then pending() and reschedule below.
+            self->ringWaiting = self->ring->waitFor(self->reader);
+        }
+
+        if(self->state==Executing && self->pending()
                 && (!self->pipeline || self->window || self->finished)) {
             // reschedule myself
             assert(!self->scheduled); // we've been holding the lock, so this should not have changed
 
-            conn->iface->server->acceptor_loop.dispatch([self]() {
+            conn->worker->loop.dispatch([self]() {
                 doReply(self);
             });
             self->scheduled = true;
@@ -214,6 +287,10 @@ struct MonitorOp final : public ServerOp
 
     void cleanup() override final
     {
+        {
+            Guard G(lock);
+            detachRing();
+        }
         ServerOp::cleanup(); // calls onCancel()
         // release any bound variables
         onHighMark = nullptr;
@@ -230,7 +307,7 @@ DEFINE_INST_COUNTER(MonitorOp);
 
 struct ServerMonitorSetup;
 
-struct ServerMonitorControl : public server::MonitorControlOp
+struct ServerMonitorControl : public server::MonitorControlOp, public UpdateRing::Reader
 {
     ServerMonitorControl(ServerMonitorSetup* setup,
                      const std::weak_ptr<server::Server::Pvt>& server,
@@ -249,8 +326,8 @@ struct ServerMonitorControl : public server::MonitorControlOp
         if(val && mon->type && mon->type.get()!=Value::Helper::desc(val))
             throw std::logic_error("Type change not allowed in post().  Recommend pvxs::Value::cloneEmpty()");
 
-        // pvMask is const at this point, so no need to lock
-        bool real = testmask(val, mon->pvMask);
+        // plan is const at this point, so no need to lock
+        bool real = testmask(val, mon->plan.mask);
 
         Guard G(mon->lock);
         if(mon->finished)
@@ -261,6 +338,8 @@ struct ServerMonitorControl : public server::MonitorControlOp
             if((mon->queue.size() < mon->limit) || force || !val) {
 
                 mon->finished = !val;
+                if(mon->finished && mon->ring)
+                    mon->ringEnd = mon->ring->head();
                 mon->queue.push_back(val);
 
                 if(mon->maxQueue < mon->queue.size())
@@ -270,7 +349,15 @@ struct ServerMonitorControl : public server::MonitorControlOp
                 // squash
                 assert(mon->limit>0 && !mon->queue.empty());
 
-                mon->queue.back().assign(val);
+                auto& last = mon->queue.back();
+                if(isEncodingShared(last)) {
+                    // also queued for other subscribers, so squash into a private copy
+                    auto merged(last.clone());
+                    merged.assign(val);
+                    last = std::move(merged);
+                } else {
+                    last.assign(val);
+                }
                 mon->nSquash++;
 
             } else {
@@ -278,12 +365,24 @@ struct ServerMonitorControl : public server::MonitorControlOp
             }
 
             if(auto serv = server.lock())
-                MonitorOp::maybeReply(serv.get(), mon);
+                MonitorOp::maybeReply(loop, mon);
         }
 
         return mon->queue.size() < mon->limit;
     }
 
+    virtual void wakeup() override final
+    {
+        auto mon(op.lock());
+        if(!mon)
+            return;
+
+        Guard G(mon->lock);
+        mon->ringWaiting = false;
+        if(auto serv = server.lock())
+            MonitorOp::maybeReply(loop, mon);
+    }
+
     virtual void stats(server::MonitorStat& stat, bool reset) const override final
     {
         auto mon(op.lock());
@@ -296,7 +395,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         stat.finished = mon->finished;
         stat.pipeline = mon->pipeline;
 
-        stat.nQueue = mon->queue.size();
+        stat.nQueue = mon->queue.size() + mon->ringPending();
         stat.maxQueue = mon->maxQueue;
         stat.limitQueue = mon->limit;
         stat.window = mon->window;
@@ -314,7 +413,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, low, high](){
+        loop.call([this, low, high](){
             if(auto oper = op.lock()) {
                 Guard G(oper->lock);
                 oper->low = std::min(low, oper->ackAt-1u);
@@ -329,7 +428,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onStart = std::move(fn);
         });
@@ -339,7 +438,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onHighMark = std::move(fn);
         });
@@ -349,7 +448,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onLowMark = std::move(fn);
         });
@@ -357,6 +456,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
 
     const std::weak_ptr<server::Server::Pvt> server;
     const std::weak_ptr<MonitorOp> op;
+    const evbase loop;
 
     INST_COUNTER(ServerMonitorControl);
 };
@@ -372,6 +472,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         :MonitorSetupOp(name, conn->cred, Info, request)
         ,server(server)
         ,op(op)
+        ,loop(conn->worker->loop.internal())
     {}
     virtual ~ServerMonitorSetup() {
         error("Monitor Create implied error");
@@ -382,19 +483,19 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         if(!prototype)
             throw std::invalid_argument("Must provide prototype");
         auto type = Value::Helper::type(prototype);
-        auto mask = request2mask(type.get(), _pvRequest);
+        EncodePlan plan(type, request2mask(type.get(), _pvRequest));
 
         std::unique_ptr<server::MonitorControlOp> ret;
 
         auto serv = server.lock();
         if(!serv)
             return ret;
-        serv->acceptor_loop.call([this, &type, &ret, &mask](){
+        loop.call([this, &type, &ret, &plan](){
             if(auto oper = op.lock()) {
                 if(oper->state!=ServerOp::Creating)
                     return;
                 oper->type = type;
-                oper->pvMask = std::move(mask);
+                oper->plan = std::move(plan);
                 ret.reset(new ServerMonitorControl(this, server, _name, oper));
                 MonitorOp::doReply(oper);
             }
@@ -412,7 +513,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg]() mutable {
+        loop.dispatch([op, msg]() mutable {
             if(auto oper = op.lock()) {
                 if(oper->state==ServerOp::Creating) {
                     oper->msg = std::move(msg);
@@ -426,7 +527,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onClose = std::move(fn);
         });
@@ -434,6 +535,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
 
     const std::weak_ptr<server::Server::Pvt> server;
     const std::weak_ptr<MonitorOp> op;
+    const evbase loop;
 
     INST_COUNTER(ServerMonitorSetup);
 };
@@ -447,10 +549,226 @@ ServerMonitorControl::ServerMonitorControl(ServerMonitorSetup* setup,
     :server::MonitorControlOp(name, setup->credentials(), Info)
     ,server(server)
     ,op(op)
+    ,loop(setup->loop)
 {}
 
 } // namespace
 
+UpdateRing::UpdateRing()
+    :snapshots(1u+4u)
+    ,entries(1u)
+{}
+
+void UpdateRing::attach(const std::shared_ptr<Reader>& reader, size_t limit)
+{
+    limit = std::max<size_t>(1u, limit);
+
+    Guard G(lock);
+    if(!readers.emplace(reader.get(), ReaderInfo{reader, next, limit}).second)
+        throw std::logic_error("UpdateRing Reader already attached");
+    cursors.insert(next);
+    limits.insert(limit);
+    resize();
+}
+
+void UpdateRing::detach(const Reader* reader)
+{
+    Guard G(lock);
+    auto it(readers.find(reader));
+    if(it==readers.end())
+        return;
+    cursors.erase(cursors.find(it->second.cursor));
+    limits.erase(limits.find(it->second.limit));
+    readers.erase(it);
+    release();
+    resize();
+    if(readers.empty())
+        snapshots.trim(); // no more updates will be read
+}
+
+void UpdateRing::evict()
+{
+    Value evicted(std::move(entries[first%entries.size()]));
+    if(!dropped)
+        dropped = evicted.cloneEmpty();
+    dropped.assign(evicted);
+    first++;
+    // evicted released, so that SnapshotPool may re-use
+}
+
+void UpdateRing::release()
+{
+    // entries before the lowest cursor have been read by all
+    auto low = cursors.empty() ? next : *cursors.begin();
+    for(; first < low; first++)
+        entries[first%entries.size()] = Value();
+    if(low >= first)
+        dropped = Value();
+}
+
+void UpdateRing::resize()
+{
+    auto depth = limits.empty() ? 1u : std::min(*limits.rbegin(), maxDepth);
+    if(depth==entries.size())
+        return;
+
+    while(next - first > depth)
+        evict();
+
+    std::vector<Value> temp(depth);
+    for(auto seq = first; seq < next; seq++)
+        temp[seq%depth] = std::move(entries[seq%entries.size()]);
+    entries.swap(temp);
+    // previous snapshots are not re-used
+    snapshots = SnapshotPool(depth+4u);
+}
+
+Value UpdateRing::push(const Value& val)
+{
+    decltype (waiting) wake;
+    Value ret;
+    {
+        Guard G(lock);
+
+        ret = snapshots.snapshot(val);
+
+        if(!readers.empty()) {
+            // when full, evict oldest, which shares a slot with next
+            if(next - first == entries.size())
+                evict();
+            entries[next%entries.size()] = ret;
+            next++;
+        } else {
+            // no one to read
+            first = ++next;
+        }
+
+        wake.swap(waiting);
+    }
+
+    for(auto& w : wake) {
+        if(auto reader = w.lock())
+            reader->wakeup();
+    }
+
+    return ret;
+}
+
+uint64_t UpdateRing::head() const
+{
+    Guard G(lock);
+    return next;
+}
+
+size_t UpdateRing::pending(const Reader* reader, uint64_t end) const
+{
+    Guard G(lock);
+    auto it(readers.find(reader));
+    if(it==readers.end())
+        return 0u;
+    auto& info = it->second;
+    end = std::min(end, next);
+    return info.cursor < end ? size_t(std::min<uint64_t>(end - info.cursor, info.limit)) : 0u;
+}
+
+Value UpdateRing::pop(const Reader* reader, uint64_t end, size_t& nsquash)
+{
+    Guard G(lock);
+    auto it(readers.find(reader));
+    if(it==readers.end())
+        return Value();
+    auto& info = it->second;
+    const auto cursor = info.cursor;
+
+    end = std::min(end, next);
+    if(cursor >= end)
+        return Value();
+
+    const auto depth = entries.size();
+    // first entry which will not be merged with those before it
+    auto keep = std::max(cursor, end - std::min<uint64_t>(end, info.limit));
+    keep = std::max(keep, first);
+
+    Value ret;
+    uint64_t after;
+
+    if(keep >= end) {
+        // everything before end has left the ring
+        nsquash += end - cursor - 1u;
+        ret = dropped.clone();
+        after = end;
+
+    } else if(cursor==keep) {
+        ret = entries[cursor%depth];
+        after = cursor + 1u;
+
+    } else {
+        // squash [cursor, keep]
+        auto seq = cursor;
+        if(cursor < first) {
+            ret = dropped.clone();
+            seq = first;
+        }
+        for(; seq <= keep; seq++) {
+            auto& ent = entries[seq%depth];
+            if(!ret)
+                ret = ent.clone();
+            else
+                ret.assign(ent);
+        }
+        nsquash += keep - cursor;
+        after = keep + 1u;
+    }
+
+    cursors.erase(cursors.find(cursor));
+    cursors.insert(after);
+    info.cursor = after;
+    release();
+
+    return ret;
+}
+
+bool UpdateRing::waitFor(const Reader* reader)
+{
+    Guard G(lock);
+    auto it(readers.find(reader));
+    if(it==readers.end() || it->second.cursor < next)
+        return false;
+    waiting.push_back(it->second.reader);
+    return true;
+}
+
+size_t UpdateRing::size() const
+{
+    Guard G(lock);
+    return next - first;
+}
+
+size_t UpdateRing::depth() const
+{
+    Guard G(lock);
+    return entries.size();
+}
+
+bool attachRing(const std::shared_ptr<server::MonitorControlOp>& sub,
+                const std::shared_ptr<UpdateRing>& ring)
+{
+    auto ctrl(std::dynamic_pointer_cast<ServerMonitorControl>(sub));
+    if(!ctrl)
+        return false;
+
+    if(auto mon = ctrl->op.lock()) {
+        Guard G(mon->lock);
+        if(mon->ring)
+            throw std::logic_error("Subscription already attached to an UpdateRing");
+        ring->attach(ctrl, mon->limit);
+        mon->ring = ring;
+        mon->reader = ctrl.get();
+        mon->ringWaiting = ring->waitFor(mon->reader);
+    }
+    return true;
+}
+
 void ServerConn::handle_MONITOR()
 {
     auto rxlen = 8u + evbuffer_get_length(segBuf.get());
@@ -607,9 +925,12 @@ void ServerConn::handle_MONITOR()
 
             op->window += nack;
 
+            // resume sending anything already queued
+            MonitorOp::maybeReply(worker->loop, op);
+
             if(!op->highMarkPending && op->window > op->high && op->onHighMark && !op->finished) {
                 op->highMarkPending = true;
-                iface->server->acceptor_loop.dispatch([op](){
+                worker->loop.dispatch([op](){
                     decltype(op->onHighMark) fn;
                     {
                         Guard G(op->lock);
@@ -639,7 +960,7 @@ void ServerConn::handle_MONITOR()
 
             {
                 Guard G(op->lock);
-                MonitorOp::maybeReply(iface->server, op);
+                MonitorOp::maybeReply(worker->loop, op);
             }
         }
 
@@ -652,7 +973,7 @@ void ServerConn::handle_MONITOR()
                 auto self(it->second);
                 opByIOID.erase(it);
 
-                iface->server->acceptor_loop.dispatch([self](){
+                worker->loop.dispatch([self](){
                     self->cleanup();
                 });
 
@@ -18,6 +18,7 @@
 
 #include "utilpvt.h"
 #include "dataimpl.h"
+#include "serverconn.h"
 
 typedef epicsGuard<epicsMutex> Guard;
 typedef epicsGuardRelease<epicsMutex> UnGuard;
@@ -46,8 +47,12 @@ struct SharedPV::Impl : public std::enable_shared_from_this<Impl>
     std::set<std::shared_ptr<ConnectOp>> pending;
     std::set<std::shared_ptr<MonitorSetupOp>> mpending;
     std::set<std::shared_ptr<MonitorControlOp>> subscribers;
+    // subset of subscribers not reading from ring
+    std::set<std::shared_ptr<MonitorControlOp>> direct;
 
     Value current;
+    // copies of current, read by subscribers.  non-NULL while open
+    std::shared_ptr<impl::UpdateRing> ring;
 
     INST_COUNTER(SharedPVImpl);
 
@@ -85,10 +90,13 @@ struct SharedPV::Impl : public std::enable_shared_from_this<Impl>
                     log_debug_printf(logshared, "%s on %s Monitor onClose\n", sub->peerName().c_str(), sub->name().c_str());
                     Guard G(self->lock);
                     self->subscribers.erase(sub);
+                    self->direct.erase(sub);
                 });
 
                 sub->post(current);
             }
+            if(!self->ring || !impl::attachRing(sub, self->ring))
+                self->direct.emplace(sub);
             self->subscribers.emplace(std::move(sub));
 
         }catch(std::exception& e){
@@ -366,6 +374,7 @@ void SharedPV::open(const Value& initial)
         mpending = std::move(impl->mpending);
 
         impl->current = initial.clone();
+        impl->ring = std::make_shared<impl::UpdateRing>();
         // make a second copy as 'temp' will be queued
         temp = initial.clone();
 
@@ -403,7 +412,9 @@ void SharedPV::close()
 
         if(impl->current)
             impl->current = Value();
+        impl->ring.reset();
 
+        impl->direct.clear();
         impl->subscribers.clear();
         channels = std::move(impl->channels);
     }
@@ -433,9 +444,12 @@ void SharedPV::post(const Value& val)
     if(impl->subscribers.empty())
         return;
 
-    auto copy(val.clone());
+    // not modified while queued, so subscribers may share one encoding.
+    // Appending is independent of the number of subscribers, but each subscriber
+    // which had caught up, and is waiting, is woken.
+    auto copy(impl->ring->push(val));
 
-    for(auto& sub : impl->subscribers) {
+    for(auto& sub : impl->direct) {
         sub->post(copy);
     }
 }
@@ -468,12 +482,51 @@ Value SharedPV::fetch() const
     }
 }
 
-struct StaticSource::Impl final : public Source
+struct StaticSource::Impl final : public Source, public IndexedSource
 {
     mutable RWLock lock;
 
     list_t pvs;
     decltype (List::names) list;
+    // of each Server we have been added to
+    std::vector<std::weak_ptr<SearchIndex>> indexes;
+
+    // with lock held for write
+    template<typename Fn>
+    void eachIndex(Fn&& fn)
+    {
+        for(auto it = indexes.begin(); it!=indexes.end();) {
+            if(auto idx = it->lock()) {
+                fn(*idx);
+                ++it;
+            } else {
+                it = indexes.erase(it); // Server destroyed w/o removeSource()
+            }
+        }
+    }
+
+    virtual void attachIndex(const std::shared_ptr<SearchIndex>& idx) override final
+    {
+        auto G(lock.lockWriter());
+        for(auto& pair : pvs) {
+            idx->add(pair.first);
+        }
+        indexes.push_back(idx);
+    }
+
+    virtual void detachIndex(const std::shared_ptr<SearchIndex>& idx) override final
+    {
+        auto G(lock.lockWriter());
+        for(auto it = indexes.begin(); it!=indexes.end(); ++it) {
+            if(it->lock()==idx) {
+                indexes.erase(it);
+                for(auto& pair : pvs) {
+                    idx->remove(pair.first);
+                }
+                break;
+            }
+        }
+    }
 
     virtual void onSearch(Search &op) override
     {
@@ -577,6 +630,9 @@ StaticSource& StaticSource::add(const std::string& name, const SharedPV &pv)
 
     impl->pvs[name] = pv;
     impl->list.reset();
+    impl->eachIndex([&name](SearchIndex& idx) {
+        idx.add(name);
+    });
 
     return *this;
 }
@@ -596,6 +652,9 @@ StaticSource& StaticSource::remove(const std::string& name)
         pv = it->second;
         impl->pvs.erase(it);
         impl->list.reset();
+        impl->eachIndex([&name](SearchIndex& idx) {
+            idx.remove(name);
+        });
     }
 
     pv.close();
@@ -5,6 +5,9 @@
  */
 
 #include <cstring>
+
+#include <algorithm>
+
 #include <epicsAssert.h>
 
 #include "dataimpl.h"
@@ -267,18 +270,11 @@ void Member::Helper::build_tree(std::vector<FieldDesc>& desc, const Member& node
         if(code.code==TypeCode::Struct)
             child.parent_index = cindex-cref;
 
-        fld.mlookup[cnode.name] = cindex-cref;
         fld.miter.emplace_back(cnode.name, cindex-cref);
-
-        std::string cname = cnode.name+".";
-        if(fld.code.code==TypeCode::Struct && fld.code==child.code) {
-            // propagate names from sub-struct
-            for(auto& cpair : child.mlookup) {
-                fld.mlookup[cname+cpair.first] = cindex-cref+cpair.second;
-            }
-        }
     }
 
+    desc[index].buildLookup();
+
     assert(desc.size()==index+desc[index].size());
 }
 
@@ -451,6 +447,103 @@ std::ostream& operator<<(std::ostream& strm, const TypeDef& def)
 
 namespace impl {
 
+namespace {
+// FNV-1a
+uint32_t hashName(const char* name, size_t len)
+{
+    uint32_t ret = 2166136261u;
+    for(auto i : range(len)) {
+        ret ^= uint8_t(name[i]);
+        ret *= 16777619u;
+    }
+    return ret;
+}
+} // namespace
+
+void FieldLookup::build(std::vector<value_type>&& ents)
+{
+    entries = std::move(ents);
+
+    // stable sort, so that the last of any duplicates replaces earlier entries
+    std::stable_sort(entries.begin(), entries.end(), [](const value_type& lhs, const value_type& rhs) {
+        return lhs.first < rhs.first;
+    });
+    {
+        size_t out = 0u;
+        for(auto i : range(entries.size())) {
+            if(out && entries[out-1u].first==entries[i].first)
+                out--;
+            if(out!=i)
+                entries[out] = std::move(entries[i]);
+            out++;
+        }
+        entries.resize(out);
+    }
+    entries.shrink_to_fit();
+
+    // at most half full
+    size_t nslots = 1u;
+    while(nslots < 2u*entries.size())
+        nslots <<= 1u;
+
+    slots.assign(nslots, 0u);
+    for(auto i : range(entries.size())) {
+        auto& name = entries[i].first;
+        for(auto h = hashName(name.data(), name.size()); ; h++) {
+            auto& slot = slots[h&(nslots-1u)];
+            if(!slot) {
+                slot = uint32_t(i+1u);
+                break;
+            }
+        }
+    }
+}
+
+void FieldDesc::buildLookup()
+{
+    const bool isStruct = code.code==TypeCode::Struct;
+    auto cbase = isStruct ? this : members.data();
+
+    size_t n = miter.size();
+    for(auto& pair : miter) {
+        if(isStruct && cbase[pair.second].code.code==TypeCode::Struct)
+            n += cbase[pair.second].mlookup.size();
+    }
+
+    std::vector<FieldLookup::value_type> entries;
+    entries.reserve(n);
+
+    for(auto& pair : miter) {
+        entries.emplace_back(pair.first, pair.second);
+
+        auto& child = cbase[pair.second];
+        if(isStruct && child.code.code==TypeCode::Struct) {
+            // propagate names from sub-struct
+            for(auto& cpair : child.mlookup) {
+                entries.emplace_back(pair.first+"."+cpair.first, pair.second+cpair.second);
+            }
+        }
+    }
+
+    mlookup.build(std::move(entries));
+}
+
+FieldLookup::const_iterator FieldLookup::find(const char* name, size_t len) const
+{
+    if(!slots.empty()) {
+        const auto mask = slots.size()-1u;
+        for(auto h = hashName(name, len); ; h++) {
+            auto slot = slots[h&mask];
+            if(!slot)
+                break;
+            auto& ent = entries[slot-1u];
+            if(ent.first.size()==len && memcmp(ent.first.data(), name, len)==0)
+                return entries.begin() + (slot-1u);
+        }
+    }
+    return entries.end();
+}
+
 void show_FieldDesc(std::ostream& strm, const FieldDesc* desc)
 {
     for(auto idx : range(desc->size())) {
@@ -461,7 +554,6 @@ void show_FieldDesc(std::ostream& strm, const FieldDesc* desc)
 
         switch(fld.code.code) {
         case TypeCode::Struct:
-            // note: need to ensure stable lexical iteration order if fld.mlookup ever becomes unordered_map
             for(auto& pair : fld.mlookup) {
                 strm<<indent{}<<"    "<<pair.first<<" -> "<<pair.second<<" ["<<(idx+pair.second)<<"]\n";
             }
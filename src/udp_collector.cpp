@@ -46,7 +46,11 @@ struct UDPCollector final : public UDPManager::Search,
     evevent rx;
     uint32_t prevndrop{};
 
+    // rxBatch receive slots.  Each datagram is preceded by room to
+    // prepend a CMD_ORIGIN_TAG when forwarding.
     std::vector<uint8_t> buf;
+    std::vector<recvfromx> rxslots;
+    std::vector<SockAddr> rxsrc, rxdest;
 
     UDPManager::Beacon beaconMsg;
 
@@ -58,7 +62,8 @@ struct UDPCollector final : public UDPManager::Search,
     void addListener(UDPListener *l);
     void delListener(UDPListener *l);
 
-    bool handle_one();
+    bool handle_many();
+    void handle_one(const recvfromx& rx);
 
     enum origin_t {
         Remote,    // non-local sender
@@ -76,8 +81,8 @@ struct UDPCollector final : public UDPManager::Search,
             if(!(ev&EV_READ))
                 return;
 
-            // handle up to 4 packets before going back to the reactor
-            for(unsigned i=0; i<4 && self->handle_one(); i++) {}
+            // handle up to 4 batches of packets before going back to the reactor
+            for(unsigned i=0; i<4 && self->handle_many(); i++) {}
 
         }catch(std::exception& e) {
             log_crit_printf(logio, "Ignoring unhandled exception in UDPManager::handle(): %s\n", e.what());
@@ -224,32 +229,60 @@ void UDPCollector::delListener(UDPListener *l)
 // size of a CMD_ORIGIN_TAG prefix header
 static constexpr size_t cmd_origin_tag_size = 8 + 16;
 
-bool UDPCollector::handle_one()
-{
-    SockAddr dest;
-
-    buf.resize(cmd_origin_tag_size + 0x10000 + 1);
-    auto rxbuf = &buf[cmd_origin_tag_size];
-    auto rxlen = buf.size()-cmd_origin_tag_size-1;
+#ifdef __linux__
+// with recvmmsg(), receive several datagrams per syscall
+static constexpr size_t rxBatch = 16u;
+#else
+static constexpr size_t rxBatch = 1u;
+#endif
 
+bool UDPCollector::handle_many()
+{
     // For Search messages, we use PV name strings in-place by adding nils.
-    // Ensure one extra byte at the end of the buffer for a nil after the last PV name
-    recvfromx rx{sock.sock, (char*)rxbuf, rxlen, &src, &dest};
-    const int nrx = rx.call();
-
-    if(nrx>=0 && rx.ndrop!=0u && prevndrop!=rx.ndrop) {
-        log_debug_printf(logio, "UDP collector socket buffer overflowed %u -> %u\n", unsigned(prevndrop), unsigned(rx.ndrop));
-        prevndrop = rx.ndrop;
+    // Ensure one extra byte at the end of each slot for a nil after the last PV name
+    constexpr size_t slotSize = cmd_origin_tag_size + 0x10000 + 1;
+
+    if(rxslots.empty()) {
+        buf.resize(rxBatch*slotSize);
+        rxsrc.resize(rxBatch);
+        rxdest.resize(rxBatch);
+        rxslots.resize(rxBatch);
+    }
+    for(size_t i=0u; i<rxBatch; i++) {
+        rxslots[i] = recvfromx{sock.sock, (char*)&buf[i*slotSize + cmd_origin_tag_size],
+                               slotSize - cmd_origin_tag_size - 1u, &rxsrc[i], &rxdest[i]};
     }
 
-    if(nrx<0) {
+    const int nmsg = recvfromx::callMany(rxslots.data(), rxslots.size());
+
+    if(nmsg<0) {
         int err = evutil_socket_geterror(sock.sock);
         if(err!=SOCK_EWOULDBLOCK && err!=EAGAIN && err!=SOCK_EINTR) {
             log_warn_printf(logio, "UDP RX Error on %s : %s\n", name.c_str(),
                             evutil_socket_error_to_string(err));
         }
         return false; // wait for more I/O
+    }
 
+    for(auto i : range(size_t(nmsg))) {
+        handle_one(rxslots[i]);
+    }
+
+    // a full batch suggests more are waiting
+    return size_t(nmsg)==rxslots.size();
+}
+
+void UDPCollector::handle_one(const recvfromx& rx)
+{
+    auto rxbuf = static_cast<const uint8_t*>(rx.buf);
+    const int nrx = rx.nrx;
+    auto& dest = *rx.dst;
+    // used by our reply()
+    src = *rx.src;
+
+    if(rx.ndrop!=0u && prevndrop!=rx.ndrop) {
+        log_debug_printf(logio, "UDP collector socket buffer overflowed %u -> %u\n", unsigned(prevndrop), unsigned(rx.ndrop));
+        prevndrop = rx.ndrop;
     }
 
     if(dest.family()!=AF_UNSPEC)
@@ -258,7 +291,7 @@ bool UDPCollector::handle_one()
     if(src.isMCast()) {
         // should never happen.  It it does, we won't be tricked into amplifying a DDoS.
         log_debug_printf(logio, "Ignoring UDP with mcast source %s.\n", src.tostring().c_str());
-        return true;
+        return;
     }
 
     log_hex_printf(logio, Level::Debug, rxbuf, nrx, "UDP Rx %d, %s -> %s @%u (%s)\n",
@@ -267,7 +300,6 @@ bool UDPCollector::handle_one()
     origin_t origin = manager->ifmap.is_iface(src) ? Local : Remote;
 
     process_one(dest, rxbuf, nrx, origin);
-    return true;
 }
 
 void UDPCollector::process_one(const SockAddr &dest, const uint8_t *buf, size_t nrx, origin_t origin)
@@ -323,7 +355,7 @@ void UDPCollector::process_one(const SockAddr &dest, const uint8_t *buf, size_t
             // invalid, bcast, or not ipv4
 
         } else if(dest.compare(lo_mcast_addr.addr,false)!=0) {
-            assert(buf==&this->buf[cmd_origin_tag_size]);
+            assert(origin!=OriginTag);
             // clear unicast flag in forwarded message
             *save_flags &= ~pva_search_flags::Unicast;
             // recipient of forwarded message must use, and trust, replyAddr in body :(
@@ -464,21 +496,22 @@ void UDPCollector::forwardM(const SockAddr& origin, const uint8_t *pbuf, size_t
     log_debug_printf(logio, "Forward as originated for %s\n",
                      origin.tostring().c_str());
 
-    assert(buf.size() > cmd_origin_tag_size);
-    assert(pbuf==&buf[cmd_origin_tag_size]);
+    // pbuf is a datagram in one of our receive slots, preceded by room for the prefix
+    auto prefix = const_cast<uint8_t*>(pbuf) - cmd_origin_tag_size;
+    assert(prefix>=buf.data() && pbuf+plen<=buf.data()+buf.size());
 
     {
-        FixedBuf M(true, &buf[0], cmd_origin_tag_size);
+        FixedBuf M(true, prefix, cmd_origin_tag_size);
 
         to_wire(M, Header{CMD_ORIGIN_TAG, 0, 16u});
         to_wire(M, origin);
         assert(M.good());
-        assert(M.save()==&buf[cmd_origin_tag_size]);
+        assert(M.save()==pbuf);
     }
 
     sock.mcast_prep_sendto(lo_mcast_addr);
     src = lo_mcast_addr.addr;
-    reply(&buf[0], cmd_origin_tag_size+plen);
+    reply(prefix, cmd_origin_tag_size+plen);
 }
 
 bool UDPCollector::reply(const void *msg, size_t msglen) const
@@ -5,15 +5,19 @@
  */
 
 #include <cmath>
+#include <cstdlib>
 #include <vector>
 #include <ostream>
 #include <algorithm>
+#include <atomic>
+#include <new>
 
 #include <pvxs/data.h>
 #include <pvxs/nt.h>
 #include <pvxs/unittest.h>
 
 #include "pvaproto.h"
+#include "dataimpl.h"
 #include <utilpvt.h>
 
 #include <evhelper.h>
@@ -22,6 +26,40 @@
 #include <epicsUnitTest.h>
 #include <testMain.h>
 
+// count heap allocations, and bytes retained, while enabled.  eg. by type creation
+static std::atomic<bool> countAllocs{false};
+static std::atomic<size_t> nAllocs{0u};
+static std::atomic<ptrdiff_t> nAllocBytes{0};
+
+// each allocation is prefixed with its size, and whether it was counted
+static constexpr size_t allocHeader = 16u;
+
+void* operator new(size_t n)
+{
+    bool count = countAllocs.load(std::memory_order_relaxed);
+    auto ret = static_cast<char*>(malloc(allocHeader + n));
+    if(!ret)
+        throw std::bad_alloc();
+    if(count) {
+        nAllocs++;
+        nAllocBytes += n;
+    }
+    reinterpret_cast<size_t*>(ret)[0] = n;
+    reinterpret_cast<size_t*>(ret)[1] = count;
+    return ret + allocHeader;
+}
+
+void operator delete(void* p) noexcept
+{
+    if(!p)
+        return;
+    auto base = static_cast<char*>(p) - allocHeader;
+    if(reinterpret_cast<size_t*>(base)[1])
+        nAllocBytes -= reinterpret_cast<size_t*>(base)[0];
+    free(base);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
 namespace {
 using namespace pvxs;
 
@@ -144,6 +182,528 @@ void benchArraySerDes(bool be, const shared_array<const E>& arr)
     testShow()<<" Des "<<Tdes;
 }
 
+// byte order reversal, for each width, with each kernel available
+void benchSwap(size_t nbytes)
+{
+    testDiag("%s(%zu) selected %s", __func__, nbytes, impl::swapKernelName(impl::swapKernelSelected()));
+
+    constexpr size_t niter = 100u;
+
+    std::vector<uint8_t> src(nbytes), dest(nbytes);
+    for(auto i : range(nbytes))
+        src[i] = uint8_t(i);
+
+    for(size_t width : {2u, 4u, 8u}) {
+        for(auto kern : {impl::SwapKernel::Scalar, impl::SwapKernel::SSE2,
+                         impl::SwapKernel::AVX2, impl::SwapKernel::NEON})
+        {
+            Sampler T;
+
+            for(auto n : range(niter)) {
+                (void)n;
+                StopWatch W;
+                (void)W.click();
+                if(!impl::copySwappedWith(kern, dest.data(), src.data(), nbytes/width, width))
+                    break;
+                T.sample(W.click());
+            }
+
+            if(T.nsamp)
+                testShow()<<" width="<<width<<" "<<impl::swapKernelName(kern)<<" "<<T;
+        }
+    }
+}
+
+// NTNDArray with many scalar fields, as when many attributes are flattened into a structure
+Value buildWideStruct(size_t nfields)
+{
+    std::vector<Member> extra;
+    extra.reserve(nfields);
+    for(auto i : range(nfields)) {
+        TypeCode code;
+        switch(i%3u) {
+        case 0u: code = TypeCode::Float64; break;
+        case 1u: code = TypeCode::Int32; break;
+        default: code = TypeCode::String; break;
+        }
+        extra.emplace_back(code, SB()<<"attr"<<i);
+    }
+
+    auto def(nt::NTNDArray{}.build());
+    def += {Member(TypeCode::Struct, "extra", extra)};
+
+    auto val(def.create());
+    for(auto fld : val["extra"].ichildren()) {
+        if(fld.type()==TypeCode::String)
+            fld = "some attribute value";
+        else
+            fld = 42;
+    }
+    return val;
+}
+
+void benchStructSerDes(bool full)
+{
+    testDiag("%s(%s)", __func__, full ? "full" : "valid");
+
+    constexpr size_t niter = 1000u;
+
+    const auto val(buildWideStruct(500u));
+    auto scratch(val.cloneEmpty());
+
+    evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+    TypeStore ctxt;
+
+    Sampler Tser, Tdes;
+
+    for(auto n : range(niter)) {
+        (void)n;
+        StopWatch W;
+
+        {
+            EvOutBuf buf(hostBE, ebuf.get());
+            (void)W.click();
+            if(full)
+                to_wire_full(buf, val);
+            else
+                to_wire_valid(buf, val);
+            Tser.sample(W.click());
+        }
+
+        {
+            EvInBuf buf(hostBE, ebuf.get());
+            (void)W.click();
+            if(full)
+                from_wire_full(buf, ctxt, scratch);
+            else
+                from_wire_valid(buf, ctxt, scratch);
+            Tdes.sample(W.click());
+        }
+    }
+
+    testShow()<<" Ser "<<Tser;
+    testShow()<<" Des "<<Tdes;
+}
+
+// as a server monitor would, with a pvRequest mask
+void benchStructPlan()
+{
+    testDiag("%s", __func__);
+
+    constexpr size_t niter = 1000u;
+
+    const auto val(buildWideStruct(500u));
+    const auto N = Value::Helper::desc(val)->size();
+
+    // empty pvRequest selects all fields
+    BitMask mask(N);
+    for(auto i : range(N))
+        mask[i] = true;
+    impl::EncodePlan plan(Value::Helper::type(val), std::move(mask));
+    const auto& pmask = plan.mask;
+
+    evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+
+    Sampler Tmask, Tplan;
+
+    for(auto n : range(niter)) {
+        (void)n;
+        StopWatch W;
+
+        {
+            EvOutBuf buf(hostBE, ebuf.get());
+            (void)W.click();
+            to_wire_valid(buf, val, &pmask);
+            Tmask.sample(W.click());
+        }
+        evbuffer_drain(ebuf.get(), evbuffer_get_length(ebuf.get()));
+
+        {
+            EvOutBuf buf(hostBE, ebuf.get());
+            (void)W.click();
+            to_wire_valid(buf, val, plan);
+            Tplan.sample(W.click());
+        }
+        evbuffer_drain(ebuf.get(), evbuffer_get_length(ebuf.get()));
+    }
+
+    testShow()<<" Mask "<<Tmask;
+    testShow()<<" Plan "<<Tplan;
+}
+
+// field lookup by name
+void benchLookup(const char* ntname, const Value& prototype, const std::vector<std::string>& names)
+{
+    testDiag("%s(%s)", __func__, ntname);
+
+    constexpr size_t niter = 1000u;
+
+    auto val(prototype.cloneEmpty());
+
+    std::vector<FieldHandle> handles;
+    for(auto& name : names)
+        handles.push_back(prototype.handle(name));
+
+    Sampler Tname, Thandle;
+
+    for(auto n : range(niter)) {
+        (void)n;
+        StopWatch W;
+        (void)W.click();
+        for(auto& name : names)
+            (void)val[name];
+        Tname.sample(W.click()/double(names.size()));
+
+        (void)W.click();
+        for(auto& handle : handles)
+            (void)val[handle];
+        Thandle.sample(W.click()/double(names.size()));
+    }
+
+    testShow()<<" Name   "<<Tname;
+    testShow()<<" Handle "<<Thandle;
+}
+
+// fill in an update
+void benchFieldRef()
+{
+    testDiag("%s", __func__);
+
+    constexpr size_t niter = 10000u;
+
+    const Value prototype(nt::NTScalar{TypeCode::Float64}.create());
+    auto update(prototype.cloneEmpty());
+
+    FieldRef<double> fvalue(prototype, "value");
+    FieldRef<int64_t> fsec(prototype, "timeStamp.secondsPastEpoch");
+    FieldRef<int32_t> fnsec(prototype, "timeStamp.nanoseconds");
+
+    Sampler Tname, Tref;
+
+    for(auto n : range(niter)) {
+        StopWatch W;
+        (void)W.click();
+        update["value"] = double(n);
+        update["timeStamp.secondsPastEpoch"] = n;
+        update["timeStamp.nanoseconds"] = n;
+        Tname.sample(W.click());
+
+        (void)W.click();
+        fvalue.set(update, double(n));
+        fsec.set(update, n);
+        fnsec.set(update, n);
+        Tref.sample(W.click());
+    }
+
+    testShow()<<" Name     "<<Tname;
+    testShow()<<" FieldRef "<<Tref;
+}
+
+struct Reading {
+    double value;
+    int32_t severity;
+    int64_t sec;
+    int32_t nsec;
+};
+
+// copy a fixed layout struct into an update
+void benchStructMap()
+{
+    testDiag("%s", __func__);
+
+    constexpr size_t niter = 10000u;
+
+    const auto readingMap(StructMap<Reading>(nt::NTScalar{TypeCode::Float64}.build())
+                          .add("value", &Reading::value)
+                          .add("alarm.severity", &Reading::severity)
+                          .add("timeStamp.secondsPastEpoch", &Reading::sec)
+                          .add("timeStamp.nanoseconds", &Reading::nsec));
+    auto update(readingMap.create());
+
+    Sampler Tname, Tmap;
+
+    for(auto n : range(niter)) {
+        Reading rd{double(n), int32_t(n%4u), int64_t(n), int32_t(n)};
+
+        StopWatch W;
+        (void)W.click();
+        update["value"] = rd.value;
+        update["alarm.severity"] = rd.severity;
+        update["timeStamp.secondsPastEpoch"] = rd.sec;
+        update["timeStamp.nanoseconds"] = rd.nsec;
+        Tname.sample(W.click());
+
+        (void)W.click();
+        readingMap.store(update, rd);
+        Tmap.sample(W.click());
+    }
+
+    testShow()<<" Name      "<<Tname;
+    testShow()<<" StructMap "<<Tmap;
+}
+
+// heap used to build a type description
+void benchTypeMemory(const char* ntname, std::function<TypeDef()> fn)
+{
+    testDiag("%s(%s)", __func__, ntname);
+
+    nAllocs = nAllocBytes = 0u;
+    countAllocs = true;
+    auto def(fn());
+    countAllocs = false;
+
+    testShow()<<" "<<nAllocs<<" allocations, "<<nAllocBytes<<" bytes retained";
+}
+
+// instance size, and encode time, of a structure with many scalar fields
+// every fourth field a String when strings=true
+void benchLargeStruct(size_t nfields, bool strings)
+{
+    testDiag("%s(%zu, %c)", __func__, nfields, strings ? 'Y' : 'N');
+
+    constexpr size_t niter = 1000u;
+
+    const TypeCode codes[] = {TypeCode::Int8, TypeCode::Int16, TypeCode::Int32, TypeCode::UInt32,
+                              TypeCode::Float32, TypeCode::Float64, TypeCode::Bool, TypeCode::Int64};
+    std::vector<Member> fields;
+    for(auto i : range(nfields))
+        fields.emplace_back(strings && i%4u==3u ? TypeCode::String : codes[i%8u], SB()<<"f"<<i);
+    const Value prototype(TypeDef(TypeCode::Struct, "", fields).create());
+
+    nAllocs = nAllocBytes = 0u;
+    countAllocs = true;
+    auto val(prototype.cloneEmpty());
+    countAllocs = false;
+    testShow()<<" instance "<<nAllocs<<" allocations, "<<nAllocBytes<<" bytes, sizeof(FieldStorage)="<<sizeof(impl::FieldStorage);
+
+    for(auto fld : val.ichildren())
+        fld = 1;
+
+    std::vector<uint8_t> bytes(16u*nfields);
+    Sampler Tfull, Tvalid;
+    for(auto n : range(niter)) {
+        (void)n;
+        StopWatch W;
+        (void)W.click();
+        {
+            VectorOutBuf buf(hostBE, bytes);
+            to_wire_full(buf, val);
+        }
+        Tfull.sample(W.click());
+        {
+            VectorOutBuf buf(hostBE, bytes);
+            to_wire_valid(buf, val);
+        }
+        Tvalid.sample(W.click());
+    }
+    testShow()<<" encode full  "<<Tfull<<" -> "<<1e3*nfields/Tfull.mean()<<" Mfields/sec";
+    testShow()<<" encode valid "<<Tvalid<<" -> "<<1e3*nfields/Tvalid.mean()<<" Mfields/sec";
+
+    // typical monitor update, with few of many fields changed
+    val.unmark();
+    size_t nmarked = 0u;
+    for(auto fld : val.ichildren()) {
+        if(nmarked++%64u==0u)
+            fld.mark();
+    }
+
+    Sampler Tsparse;
+    for(auto n : range(niter)) {
+        (void)n;
+        StopWatch W;
+        (void)W.click();
+        {
+            VectorOutBuf buf(hostBE, bytes);
+            to_wire_valid(buf, val);
+        }
+        Tsparse.sample(W.click());
+    }
+    testShow()<<" encode 1/64  "<<Tsparse;
+}
+
+// copy of each update made by SharedPV::post(), while a few earlier updates are still queued
+void benchPostSnapshot()
+{
+    testDiag("%s", __func__);
+
+    constexpr size_t niter = 10000u;
+    constexpr size_t depth = 4u; // eg. MonitorOp queue limit
+
+    const Value prototype(nt::NTScalar{TypeCode::Float64, true, true, true}.create());
+    auto update(prototype.cloneEmpty());
+
+    Sampler Tclone, Tpool;
+    impl::SnapshotPool pool;
+
+    for(bool usePool : {false, true}) {
+        std::vector<Value> queued(depth);
+
+        for(auto n : range(niter)) {
+            update["value"] = double(n);
+            update["timeStamp.nanoseconds"] = n;
+
+            StopWatch W;
+            (void)W.click();
+            Value copy;
+            if(usePool) {
+                copy = pool.snapshot(update);
+            } else {
+                copy = update.clone();
+                impl::shareEncoding(copy);
+            }
+            (usePool ? Tpool : Tclone).sample(W.click());
+
+            queued[n%depth] = std::move(copy); // releases oldest
+        }
+    }
+
+    testShow()<<" clone() "<<Tclone<<" -> "<<1e9/Tclone.mean()<<" posts/sec";
+    testShow()<<" Pool    "<<Tpool<<" -> "<<1e9/Tpool.mean()<<" posts/sec";
+}
+
+// Value for each client monitor update, while a few earlier updates are still queued
+void benchStructPool()
+{
+    testDiag("%s", __func__);
+
+    constexpr size_t niter = 10000u;
+    constexpr size_t depth = 4u; // eg. client queueSize
+
+    const Value prototype(nt::NTScalar{TypeCode::Float64, true, true, true}.create());
+    auto pool(std::make_shared<impl::StructPool>(prototype, 2u*depth));
+
+    for(bool usePool : {false, true}) {
+        std::vector<Value> queued(depth);
+        Sampler T;
+        size_t allocs = 0u;
+
+        for(auto n : range(niter)) {
+            StopWatch W;
+            (void)W.click();
+            nAllocs = 0u;
+            countAllocs = true;
+            Value update(usePool ? pool->create() : prototype.cloneEmpty());
+            countAllocs = false;
+            T.sample(W.click());
+            allocs += nAllocs;
+
+            update["value"] = double(n);
+            update["timeStamp.nanoseconds"] = n;
+            queued[n%depth] = std::move(update); // releases oldest
+        }
+
+        testShow()<<(usePool ? " Pool         " : " cloneEmpty() ")<<T
+                  <<", "<<double(allocs)/niter<<" allocations per update";
+    }
+}
+
+// fill an NTTable row by row.  Through Value indexing, and with nt::TableBuilder
+void benchTableBuild(size_t nrows, bool viaValue)
+{
+    testDiag("%s(%zu, %s)", __func__, nrows, viaValue ? "Value" : "TableBuilder");
+
+    const auto prototype(nt::NTTable{}
+                         .add_column(TypeCode::Float64, "time")
+                         .add_column(TypeCode::Int32, "severity")
+                         .add_column(TypeCode::String, "message")
+                         .create());
+
+    StopWatch W;
+    (void)W.click();
+
+    Value table;
+    if(viaValue) {
+        table = prototype.clone();
+        for(auto i : range(nrows)) {
+            auto time(table["value.time"].as<shared_array<const double>>().thaw());
+            auto sevr(table["value.severity"].as<shared_array<const int32_t>>().thaw());
+            auto msg(table["value.message"].as<shared_array<const std::string>>().thaw());
+            time.resize(i+1u);
+            sevr.resize(i+1u);
+            msg.resize(i+1u);
+            time[i] = double(i);
+            sevr[i] = int32_t(i%4u);
+            msg[i] = "OK";
+            table["value.time"] = time.freeze();
+            table["value.severity"] = sevr.freeze();
+            table["value.message"] = msg.freeze();
+        }
+
+    } else {
+        nt::TableBuilder builder(prototype);
+        auto time(builder.column<double>("time"));
+        auto sevr(builder.column<int32_t>("severity"));
+        auto msg(builder.column<std::string>("message"));
+        for(auto i : range(nrows)) {
+            auto row(builder.append());
+            time[row] = double(i);
+            sevr[row] = int32_t(i%4u);
+            msg[row] = "OK";
+        }
+        table = builder.build();
+    }
+    auto Tbuild(W.click());
+
+    std::vector<uint8_t> bytes;
+    {
+        VectorOutBuf buf(true, bytes);
+        to_wire_full(buf, table);
+    }
+    auto Tser(W.click());
+
+    testShow()<<" build "<<Tbuild/1e3<<" us ("<<double(Tbuild)/nrows<<" ns/row), serialize "<<Tser/1e3<<" us";
+}
+
+// one update sent to many subscribers, with and without a shared encoding
+void benchSharedEncoding(bool be, size_t nsub)
+{
+    testDiag("%s(%c, %zu)", __func__, be ? 'B' : 'L', nsub);
+
+    constexpr size_t niter = 20u;
+
+    auto initial(nt::NTScalar{TypeCode::Float64A}.create());
+    {
+        shared_array<double> arr(1u<<17u); // 1 MB
+        for(auto i : range(arr.size()))
+            arr[i] = i;
+        initial["value"] = arr.freeze();
+    }
+    const auto N = Value::Helper::desc(initial)->size();
+
+    BitMask mask(N);
+    for(auto i : range(N))
+        mask[i] = true;
+    impl::EncodePlan plan(Value::Helper::type(initial), std::move(mask));
+
+    evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+
+    Sampler Tcopy, Tshared;
+
+    for(auto n : range(niter)) {
+        (void)n;
+        StopWatch W;
+
+        for(bool share : {false, true}) {
+            // as for each SharedPV::post()
+            auto val(initial.clone());
+            if(share)
+                impl::shareEncoding(val);
+
+            (void)W.click();
+            for(auto s : range(nsub)) {
+                (void)s;
+                EvOutBuf buf(be, ebuf.get());
+                to_wire_valid(buf, val, plan);
+            }
+            (share ? Tshared : Tcopy).sample(W.click());
+            evbuffer_drain(ebuf.get(), evbuffer_get_length(ebuf.get()));
+        }
+    }
+
+    testShow()<<" Each   "<<Tcopy;
+    testShow()<<" Shared "<<Tshared;
+}
+
 } // namespace
 
 MAIN(benchdata)
@@ -162,6 +722,25 @@ MAIN(benchdata)
         benchArraySerDes<uint64_t>(hostBE, arr);
         benchArraySerDes<uint64_t>(!hostBE, arr);
     }
+    {
+        shared_array<float> temp(nelem);
+        for(auto n : range(temp.size())) {
+            temp[n] = n;
+        }
+        shared_array<const float> arr(temp.freeze());
+        benchArraySerDes<float>(hostBE, arr);
+        benchArraySerDes<float>(!hostBE, arr);
+    }
+    {
+        shared_array<uint16_t> temp(nelem);
+        for(auto n : range(temp.size())) {
+            temp[n] = n;
+        }
+        shared_array<const uint16_t> arr(temp.freeze());
+        benchArraySerDes<uint16_t>(hostBE, arr);
+        benchArraySerDes<uint16_t>(!hostBE, arr);
+    }
+    benchSwap(4u<<20u); // eg. a 1 MPixel Float32 image
     testDiag("baseline unoptimized for a variable size element");
     {
         shared_array<std::string> temp(nelem);
@@ -172,5 +751,28 @@ MAIN(benchdata)
         benchArraySerDes<std::string>(hostBE, arr);
         benchArraySerDes<std::string>(!hostBE, arr);
     }
+    testDiag("traversal of a structure with many fields");
+    benchStructSerDes(true);
+    benchStructSerDes(false);
+    benchStructPlan();
+    benchLookup("NTScalar", nt::NTScalar{TypeCode::Float64, true, true, true}.create(),
+                {"value", "alarm.severity", "timeStamp.secondsPastEpoch", "timeStamp.nanoseconds",
+                 "display.limitHigh", "valueAlarm.highAlarmLimit"});
+    benchLookup("NTNDArray", nt::NTNDArray{}.create(),
+                {"value", "codec.name", "compressedSize", "uniqueId", "dataTimeStamp.nanoseconds",
+                 "alarm.severity", "timeStamp.secondsPastEpoch", "dimension", "attribute"});
+    benchFieldRef();
+    benchStructMap();
+    benchTypeMemory("NTScalar", []() { return nt::NTScalar{TypeCode::Float64, true, true, true}.build(); });
+    benchTypeMemory("NTNDArray", []() { return nt::NTNDArray{}.build(); });
+    benchLargeStruct(1000u, false);
+    benchLargeStruct(1000u, true);
+    benchPostSnapshot();
+    benchStructPool();
+    benchTableBuild(2000u, true);
+    benchTableBuild(2000u, false);
+    benchTableBuild(100000u, false);
+    benchSharedEncoding(hostBE, 200u);
+    benchSharedEncoding(!hostBE, 200u);
     return testDone();
 }
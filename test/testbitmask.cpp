@@ -120,6 +120,36 @@ void testExpr()
     testEq(std::string(SB()<<Complex), "{2, 4, 5}");
 }
 
+void testRange()
+{
+    testDiag("%s", __func__);
+
+    BitMask M({3, 63, 64, 130, 200}, 260u);
+    testEq(M.wsize(), 5u);
+    testEq(M.count(), 5u);
+
+    testEq(M.findSet(4u, 63u), 63u); // none in range
+    testEq(M.findSet(4u, 64u), 63u);
+    testEq(M.findSet(65u, 130u), 130u);
+    testEq(M.findSet(65u, 129u), 129u);
+    testEq(M.findSet(131u, 1000u), 200u);
+    testEq(M.findSet(201u), 260u);
+
+    std::vector<size_t> bits;
+    for(auto bit : M.onlySet(4u, 131u))
+        bits.push_back(bit);
+    testEq(bits.size(), 3u);
+    testOk1(bits==std::vector<size_t>({63u, 64u, 130u}));
+
+    bits.clear();
+    for(auto bit : M.onlySet(64u, 200u))
+        bits.push_back(bit);
+    testOk1(bits==std::vector<size_t>({64u, 130u}));
+
+    BitMask Not(!M);
+    testEq(Not.count(), 255u); // storage bits beyond size() not counted
+}
+
 template<size_t N>
 void testSerCase(bool be, uint8_t(&input)[N], const char *expect)
 {
@@ -199,7 +229,7 @@ void testSer()
 
 MAIN(testbitmask)
 {
-    testPlan(76);
+    testPlan(88);
     testSetup();
     testEmpty();
     testBasic1();
@@ -207,6 +237,7 @@ MAIN(testbitmask)
     testBasic3();
     testOp();
     testExpr();
+    testRange();
     testSer();
     cleanup_for_valgrind();
     return testDone();
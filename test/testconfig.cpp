@@ -113,6 +113,9 @@ void testDefs()
         conf.interfaces = {"1.2.3.4", "1.1.1.1"};
         conf.beaconDestinations = {"1.2.1.2", "4.3.2.1:1234"};
         conf.auto_beacon = false;
+        conf.nWorkers = 4u;
+        conf.searchCacheTimeout = 2.5;
+        conf.searchRate = 100.0;
 
         conf.updateDefs(defs);
         testEq(defs["EPICS_PVA_BROADCAST_PORT"], "1234");
@@ -125,6 +128,9 @@ void testDefs()
         testEq(defs["EPICS_PVAS_BEACON_ADDR_LIST"], "1.2.1.2 4.3.2.1:1234");
         testEq(defs["EPICS_PVA_INTF_ADDR_LIST"], "1.2.3.4 1.1.1.1");
         testEq(defs["EPICS_PVAS_INTF_ADDR_LIST"], "1.2.3.4 1.1.1.1");
+        testEq(defs["EPICS_PVAS_TCP_WORKERS"], "4");
+        testEq(defs["EPICS_PVAS_SEARCH_CACHE_TMO"], "2.5");
+        testEq(defs["EPICS_PVAS_SEARCH_RATE"], "100");
     }
 
     {
@@ -136,12 +142,18 @@ void testDefs()
         defs["EPICS_PVAS_AUTO_BEACON_ADDR_LIST"] = "NO";
         defs["EPICS_PVAS_BEACON_ADDR_LIST"] = "1.2.1.2 4.3.2.1:1234";
         defs["EPICS_PVAS_INTF_ADDR_LIST"] = "1.2.3.4 1.1.1.1";
+        defs["EPICS_PVAS_TCP_WORKERS"] = "3";
+        defs["EPICS_PVAS_SEARCH_CACHE_TMO"] = "1.5";
+        defs["EPICS_PVAS_SEARCH_RATE"] = "50";
         conf.applyDefs(defs);
         testEq(conf.udp_port, 1234);
         testEq(conf.tcp_port, 5678);
         testFalse(conf.auto_beacon);
         testEq(conf.beaconDestinations, std::vector<std::string>({"1.2.1.2:1234", "4.3.2.1:1234"}));
         testEq(conf.interfaces, std::vector<std::string>({"1.1.1.1:5678", "1.2.3.4:5678"}));
+        testEq(conf.nWorkers, 3u);
+        testEq(conf.searchCacheTimeout, 1.5);
+        testEq(conf.searchRate, 50.0);
     }
 }
 
@@ -179,7 +191,7 @@ void testClientAuto()
 
 MAIN(testconfig)
 {
-    testPlan(31);
+    testPlan(37);
     testSetup();
     testDefs();
     logger_config_env();
@@ -49,6 +49,257 @@ void testTraverse()
     testFalse(top.equalType(top["value"]));
 }
 
+void testFieldLookup()
+{
+    testDiag("%s", __func__);
+
+    impl::FieldLookup L;
+    testTrue(L.empty());
+    testTrue(L.find("x")==L.end());
+
+    L.build({{"zz", 1u}, {"a.b", 2u}, {"a", 3u}, {"zz", 4u}, {"m", 5u}});
+    testEq(L.size(), 4u);
+
+    std::string names;
+    for(auto& pair : L) {
+        names += pair.first;
+        names += ' ';
+    }
+    testEq(names, "a a.b m zz ")<<" sorted";
+
+    auto it = L.find("zz");
+    testTrue(it!=L.end() && it->second==4u)<<" last duplicate kept";
+    const std::string abc("a.b.c");
+    it = L.find(abc.data(), 3u);
+    testTrue(it!=L.end() && it->second==2u)<<" prefix of a longer string";
+    testTrue(L.find("a.")==L.end());
+    testTrue(L.find("")==L.end());
+    testTrue(L.find("b")==L.end());
+
+    // many entries, all found
+    std::vector<impl::FieldLookup::value_type> ents;
+    for(auto i : range(1000u))
+        ents.emplace_back(SB()<<"f"<<i, i);
+    L.build(std::move(ents));
+    size_t nbad = 0u;
+    for(auto i : range(1000u)) {
+        it = L.find(SB()<<"f"<<i);
+        if(it==L.end() || it->second!=i)
+            nbad++;
+    }
+    testEq(nbad, 0u);
+}
+
+void testFieldHandle()
+{
+    testDiag("%s", __func__);
+
+    auto top = nt::NTScalar{TypeCode::Int32, true}.create();
+    auto hval(top.handle("value"));
+    auto hsevr(top.handle("alarm.severity"));
+    auto hparent(top["alarm"].handle("<timeStamp.nanoseconds"));
+    auto hsub(top["alarm"].handle("status"));
+
+    testEq(hval.name(), "value");
+    testTrue(hval.valid());
+    testFalse(FieldHandle().valid());
+    testFalse(top[FieldHandle()].valid());
+
+    testThrows<LookupError>([&top]() {
+        (void)top.handle("nonexistent");
+    });
+    testThrows<NoField>([]() {
+        (void)Value().handle("value");
+    });
+
+    // same type
+    auto val(top.cloneEmpty());
+    val[hval] = 42;
+    val[hsevr] = 2;
+    testTrue(val[hval].equalInst(val["value"]));
+    testEq(val["value"].as<int32_t>(), 42);
+    testEq(val["alarm.severity"].as<int32_t>(), 2);
+    testTrue(val["alarm"][hsub].equalInst(val["alarm.status"]));
+    testTrue(val["alarm"][hparent].equalInst(val["timeStamp.nanoseconds"]));
+    {
+        const Value& cval = val;
+        testTrue(cval[hsevr].equalInst(val["alarm.severity"]));
+    }
+
+    // handle from sub-struct used with the whole struct is looked up by name
+    testFalse(val[hsub].valid());
+
+    // equivalent type, but different description
+    auto other(nt::NTScalar{TypeCode::Int32, true}.create());
+    testTrue(other[hval].equalInst(other["value"]));
+    testTrue(other[hsevr].equalInst(other["alarm.severity"]));
+
+    // through a Union
+    using namespace pvxs::members;
+    auto u(TypeDef(TypeCode::Struct, {
+                       Union("u", {
+                           Int32("i"),
+                           String("s"),
+                       }),
+                   }).create());
+    u["u->s"] = "";
+    auto hs(u.handle("u->s")); // const lookup can't select
+    u[hs] = "hello";
+    testEq(u["u->s"].as<std::string>(), "hello");
+    testTrue(u[hs].equalInst(u["u->s"]));
+}
+
+void testFieldRef()
+{
+    testDiag("%s", __func__);
+
+    auto def(nt::NTScalar{TypeCode::Float64, true}.build());
+    auto prototype(def.create());
+
+    FieldRef<double> fvalue(prototype, "value");
+    FieldRef<epicsAlarmSeverity> fsevr(def, "alarm.severity");
+    FieldRef<std::string> fmsg(prototype, "alarm.message");
+    FieldRef<std::string> fvalueStr(prototype, "value");
+
+    testEq(fvalue.name(), "value");
+    testTrue(fvalue.valid());
+    testFalse(FieldRef<double>().valid());
+
+    testThrows<LookupError>([&prototype]() {
+        FieldRef<double>(prototype, "nonexistent");
+    });
+    testThrows<NoConvert>([&prototype]() {
+        FieldRef<double>(prototype, "alarm");
+    });
+    testThrows<NoConvert>([&prototype]() {
+        FieldRef<Value>(prototype, "alarm");
+    });
+    testThrows<NoConvert>([&prototype]() {
+        FieldRef<shared_array<const double>>(prototype, "value");
+    });
+
+    auto val(prototype.cloneEmpty());
+    fvalue.set(val, 4.5);
+    fsevr.set(val, MAJOR_ALARM);
+    fmsg.set(val, "hello");
+
+    testEq(val["value"].as<double>(), 4.5);
+    testTrue(val["value"].isMarked());
+    testTrue(val["alarm"].isMarked(true, true));
+    testEq(val["alarm.severity"].as<int32_t>(), MAJOR_ALARM);
+    testEq(fsevr.get(val), MAJOR_ALARM);
+    testEq(fmsg.get(val), "hello");
+    testEq(fvalueStr.get(val), "4.5");
+
+    {
+        double out = 0.0;
+        testTrue(fvalue.get(val, out));
+        testEq(out, 4.5);
+        fmsg.set(val, "not a number");
+        FieldRef<double> fmsgNum(prototype, "alarm.message");
+        testFalse(fmsgNum.get(val, out));
+        testThrows<NoConvert>([&fmsgNum, &val]() {
+            fmsgNum.get(val);
+        });
+    }
+
+    // equivalent type, through lookup by name
+    auto other(nt::NTScalar{TypeCode::Float64, true}.create());
+    fvalue.set(other, 1.5);
+    testEq(other["value"].as<double>(), 1.5);
+    testEq(fvalue.get(other), 1.5);
+
+    // different type
+    auto strval(nt::NTScalar{TypeCode::String}.create());
+    fvalue.set(strval, 2.5);
+    testEq(strval["value"].as<std::string>(), "2.5");
+
+    testThrows<NoField>([&fvalue]() {
+        fvalue.get(TypeDef(TypeCode::Struct, {}).create());
+    });
+
+    // Any is not accessed directly
+    using namespace pvxs::members;
+    auto anyval(TypeDef(TypeCode::Struct, {Any("a")}).create());
+    FieldRef<double> fany(anyval, "a");
+    fany.set(anyval, 1.5);
+    testEq(anyval["a"].as<double>(), 1.5);
+    testEq(fany.get(anyval), 1.5);
+}
+
+struct MapPoint {
+    double x;
+    float y;
+    epicsAlarmSeverity severity;
+    std::string label;
+    shared_array<const int16_t> samples;
+};
+
+void testStructMap()
+{
+    testDiag("%s", __func__);
+
+    auto pointMap(StructMap<MapPoint>("point_t")
+                  .add(PVXS_MEMBER(MapPoint, x))
+                  .add(PVXS_MEMBER(MapPoint, y))
+                  .add(PVXS_MEMBER(MapPoint, severity))
+                  .add(PVXS_MEMBER(MapPoint, label))
+                  .add(PVXS_MEMBER(MapPoint, samples)));
+
+    auto val(pointMap.create());
+    testEq(val.id(), "point_t");
+    testEq(val["x"].type(), TypeCode::Float64);
+    testEq(val["y"].type(), TypeCode::Float32);
+    testEq(val["severity"].type(), TypeCode::UInt32); // underlying type of enum
+    testEq(val["label"].type(), TypeCode::String);
+    testEq(val["samples"].type(), TypeCode::Int16A);
+
+    MapPoint pt{1.5, 2.5f, MAJOR_ALARM, "origin", shared_array<const int16_t>({1, 2, 3})};
+    pointMap.store(val, pt);
+    testTrue(val["x"].isMarked());
+    testEq(val["y"].as<double>(), 2.5);
+    testEq(val["severity"].as<int32_t>(), 2);
+    testEq(val["label"].as<std::string>(), "origin");
+
+    MapPoint out{};
+    testTrue(pointMap.load(val, out));
+    testEq(out.x, 1.5);
+    testEq(out.y, 2.5f);
+    testEq(out.severity, MAJOR_ALARM);
+    testEq(out.label, "origin");
+    testTrue(out.samples.data()==pt.samples.data())<<" not copied";
+
+    // onto an existing type, appending one field
+    auto scalarMap(StructMap<MapPoint>(nt::NTScalar{TypeCode::Float64}.build())
+                   .add("value", &MapPoint::x)
+                   .add("alarm.severity", &MapPoint::severity)
+                   .add("alarm.message", &MapPoint::label)
+                   .add(PVXS_MEMBER(MapPoint, y)));
+
+    val = scalarMap.create(pt);
+    testTrue(val.idStartsWith("epics:nt/NTScalar:"))<<val;
+    testEq(val["value"].as<double>(), 1.5);
+    testEq(val["alarm.severity"].as<int32_t>(), 2);
+    testEq(val["alarm.message"].as<std::string>(), "origin");
+    testEq(val["y"].type(), TypeCode::Float32);
+    testFalse(val["timeStamp"].isMarked(true, true));
+
+    // copy is independent
+    auto copy(scalarMap);
+    copy.add(PVXS_MEMBER(MapPoint, samples));
+    testEq(copy.create(pt)["samples"].as<shared_array<const int16_t>>().size(), 3u);
+    out = MapPoint{};
+    testTrue(scalarMap.load(val, out));
+    testEq(out.x, 1.5);
+
+    testThrows<LookupError>([]() {
+        StructMap<MapPoint>().add("nonexistent.x", &MapPoint::x);
+    });
+    testThrows<NoConvert>([]() {
+        StructMap<MapPoint>(nt::NTScalar{}.build()).add("alarm", &MapPoint::label);
+    });
+}
+
 void testAssign()
 {
     testDiag("%s", __func__);
@@ -493,6 +744,113 @@ void testClear()
     testFalse(val.isMarked(true, true));
 }
 
+// dense valid bits match FieldStorage::valid
+void testValidWords()
+{
+    testShow()<<__func__;
+
+    std::vector<Member> inner, outer;
+    for(auto i : range(80u))
+        inner.emplace_back(TypeCode::UInt32, SB()<<"f"<<i);
+    for(auto i : range(100u))
+        outer.emplace_back(TypeCode::UInt32, SB()<<"f"<<i);
+    outer.push_back(members::Struct("sub", inner)); // straddles words
+
+    auto val(TypeDef(TypeCode::Struct, "", outer).create());
+    auto sub(val["sub"]);
+
+    auto expected = [](const Value& v) -> BitMask {
+        auto store = Value::Helper::store_ptr(v);
+        BitMask ret(Value::Helper::desc(v)->size());
+        for(auto i : range(ret.size()))
+            ret[i] = store[i].valid;
+        return ret;
+    };
+
+    BitMask actual;
+    impl::collectValid(actual, Value::Helper::store_ptr(val), Value::Helper::desc(val)->size());
+    testEq(actual.count(), 0u);
+
+    val["f0"] = 1;
+    val["f63"] = 1;
+    val["f64"] = 1;
+    sub["f0"] = 1;
+    sub["f27"] = 1;
+    sub["f79"] = 1;
+
+    impl::collectValid(actual, Value::Helper::store_ptr(val), Value::Helper::desc(val)->size());
+    testEq(actual, expected(val));
+    testEq(actual.count(), 6u);
+
+    impl::collectValid(actual, Value::Helper::store_ptr(sub), Value::Helper::desc(sub)->size());
+    testEq(actual, expected(sub));
+    testEq(actual.count(), 3u);
+    testTrue(actual[1u] && actual[28u] && actual[80u]);
+
+    sub.unmark();
+    impl::collectValid(actual, Value::Helper::store_ptr(val), Value::Helper::desc(val)->size());
+    testEq(actual, expected(val));
+    testEq(actual.count(), 3u);
+
+    val.clear();
+    impl::collectValid(actual, Value::Helper::store_ptr(val), Value::Helper::desc(val)->size());
+    testEq(actual.count(), 0u);
+}
+
+void testStructPool()
+{
+    testShow()<<__func__;
+
+    auto prototype = TypeDef(TypeCode::Struct, {
+                                 members::UInt32("int"),
+                                 members::String("string"),
+                                 members::UInt32A("arr"),
+                                 members::Any("any"),
+                             }).create();
+
+    auto pool(std::make_shared<impl::StructPool>(prototype, 2u));
+
+    auto val(pool->create());
+    testTrue(val.equalType(prototype));
+    testFalse(val.isMarked(true, true));
+    testEq(pool->nfree(), 0u);
+
+    val["int"] = 0x12345678;
+    val["string"] = "testing";
+    val["arr"] = shared_array<const uint32_t>({1,2,3});
+    val["any"].assign(nt::NTScalar{TypeCode::UInt32}.create());
+    auto storage = Value::Helper::store_ptr(val);
+
+    val = Value();
+    testEq(pool->nfree(), 1u);
+
+    // re-used storage is cleared
+    val = pool->create();
+    testEq(pool->nfree(), 0u);
+    testTrue(Value::Helper::store_ptr(val)==storage);
+    testEq(val["int"].as<uint32_t>(), 0u);
+    testEq(val["string"].as<std::string>(), std::string(""));
+    testEq(val["arr"].as<shared_array<const void>>().size(), 0u);
+    testFalse(val["any->"]);
+    testFalse(val.isMarked(true, true));
+
+    {
+        std::vector<Value> vals;
+        for(size_t i=0u; i<4u; i++)
+            vals.push_back(pool->create());
+    }
+    testEq(pool->nfree(), 2u); // limit
+
+    // Values keep the pool alive
+    std::weak_ptr<impl::StructPool> wpool(pool);
+    pool.reset();
+    testFalse(wpool.expired());
+    val["int"] = 42u;
+    testEq(val["int"].as<uint32_t>(), 42u);
+    val = Value();
+    testTrue(wpool.expired());
+}
+
 void test_cache_sync()
 {
     testShow()<<__func__;
@@ -550,9 +908,13 @@ void test_cache_sync()
 
 MAIN(testdata)
 {
-    testPlan(189);
+    testPlan(291);
     testSetup();
     testTraverse();
+    testFieldLookup();
+    testFieldHandle();
+    testFieldRef();
+    testStructMap();
     testAssign();
     testAssignArray();
     testAssignUnion();
@@ -634,6 +996,8 @@ MAIN(testdata)
     testUnionMagicAssign();
     testExtract();
     testClear();
+    testValidWords();
+    testStructPool();
     test_cache_sync();
     cleanup_for_valgrind();
     return testDone();
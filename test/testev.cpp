@@ -7,6 +7,7 @@
 #include <testMain.h>
 
 #include <epicsUnitTest.h>
+#include <epicsEvent.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -98,6 +99,61 @@ void test_call()
     testFalse(internal.tryCall([](){}));
 }
 
+void test_dispatch_order()
+{
+    testDiag("%s", __func__);
+
+    evbase base("TEST");
+
+    // stall the worker so that queued work overflows the ring
+    epicsEvent stall;
+    base.dispatch([&stall]() {
+        stall.wait();
+    });
+
+    std::vector<unsigned> order;
+    const unsigned nwork = 4000u;
+    for(auto i : range(nwork)) {
+        base.dispatch([&order, i]() {
+            order.push_back(i);
+        });
+    }
+
+    stall.signal();
+    base.sync();
+
+    bool inorder = order.size()==nwork;
+    for(auto i : range(order.size())) {
+        if(order[i]!=i) {
+            testDiag("order[%u] == %u", unsigned(i), order[i]);
+            inorder = false;
+            break;
+        }
+    }
+    testTrue(inorder)<<" "<<order.size()<<" of "<<nwork;
+
+    order.clear();
+
+    std::vector<mfunction> batch;
+    for(auto i : range(10u)) {
+        batch.emplace_back([&order, i]() {
+            order.push_back(i);
+        });
+    }
+    base.dispatch(std::move(batch));
+    base.sync();
+
+    testEq(order.size(), 10u);
+    testEq(order.back(), 9u);
+
+    auto internal(base.internal());
+    base = evbase();
+
+    batch.clear();
+    batch.emplace_back([](){});
+    testFalse(internal.tryDispatch(std::move(batch)));
+}
+
 void test_fill_evbuf()
 {
     testDiag("%s", __func__);
@@ -147,9 +203,10 @@ void test_fill_evbuf()
 MAIN(testev)
 {
     SockAttach attach;
-    testPlan(20);
+    testPlan(24);
     testSetup();
     test_call();
+    test_dispatch_order();
     test_fill_evbuf();
     cleanup_for_valgrind();
     return testDone();
@@ -478,6 +478,116 @@ struct ErrorSource : public server::Source
     }
 };
 
+void testWorkers()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 42;
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    auto conf(server::Config::isolated());
+    conf.nWorkers = 2u;
+
+    auto serv = conf.build()
+            .addPV("mailbox", mbox)
+            .start();
+
+    // each Context makes a separate connection
+    std::vector<client::Context> clis;
+    for(auto i : range(4u)) {
+        (void)i;
+        clis.push_back(serv.clientConfig().build());
+        auto val(clis.back().get("mailbox").exec()->wait(5.0));
+        testEq(val["value"].as<int32_t>(), 42);
+    }
+
+    auto report(serv.report());
+    if(testEq(report.workers.size(), 2u)) {
+        for(auto& worker : report.workers) {
+            testEq(worker.connections, 2u)<<" "<<worker.name;
+            testNotEq(worker.tx, 0u);
+        }
+    } else {
+        testSkip(4, "No workers");
+    }
+    testEq(report.connections.size(), 4u);
+
+    clis.clear();
+    serv.stop();
+}
+
+void testClientWorkers()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    auto serv(server::Config::isolated().build());
+
+    std::vector<server::SharedPV> pvs;
+    for(auto i : range(8u)) {
+        pvs.push_back(server::SharedPV::buildReadonly());
+        initial["value"] = int32_t(i);
+        pvs.back().open(initial.clone());
+        serv.addPV(SB()<<"pv"<<i, pvs.back());
+    }
+    serv.start();
+
+    auto conf(serv.clientConfig());
+    conf.nWorkers = 2u;
+    auto cli(conf.build());
+
+    for(auto i : range(8u)) {
+        auto val(cli.get(SB()<<"pv"<<i).exec()->wait(5.0));
+        testEq(val["value"].as<uint32_t>(), i);
+    }
+
+    auto report(cli.report());
+    if(testEq(report.workers.size(), 3u)) {
+        // the searching worker services only name server connections
+        testEq(report.workers.front().connections, 0u);
+
+        size_t total = 0u;
+        for(auto& worker : report.workers)
+            total += worker.connections;
+        testEq(total, report.connections.size());
+    } else {
+        testSkip(2, "No workers");
+    }
+
+    cli.close();
+    serv.stop();
+}
+
+// reply body longer than one segment
+void testLargeArray(bool srvBE)
+{
+    testShow()<<__func__<<" srvBE="<<srvBE;
+
+    shared_array<double> arr(400000u); // 3.2 MB
+    for(auto i : range(arr.size()))
+        arr[i] = double(i);
+    const auto expect(arr.freeze());
+
+    auto initial(nt::NTScalar{TypeCode::Float64A}.create());
+    initial["value"] = expect;
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    auto serv = server::Config::isolated()
+            .overrideSendBE(srvBE)
+            .build()
+            .addPV("mailbox", mbox)
+            .start();
+    auto cli = serv.clientConfig().build();
+
+    auto val(cli.get("mailbox").exec()->wait(5.0));
+    auto actual(val["value"].as<shared_array<const double>>());
+    testTrue(actual.size()==expect.size() && std::equal(expect.begin(), expect.end(), actual.begin()))
+            <<" size "<<actual.size();
+}
+
 void testError(bool phase)
 {
     testShow()<<__func__<<" phase="<<phase;
@@ -516,7 +626,7 @@ void testError(bool phase)
 
 MAIN(testget)
 {
-    testPlan(62);
+    testPlan(85);
     testSetup();
     logger_config_env();
     const bool canIPv6 = pvxs::impl::evsocket::canIPv6;
@@ -537,6 +647,10 @@ MAIN(testget)
     Tester().badRequest();
     Tester().delayExec();
     Tester().ordering();
+    testWorkers();
+    testClientWorkers();
+    testLargeArray(false);
+    testLargeArray(true);
     testError(false);
     testError(true);
     cleanup_for_valgrind();
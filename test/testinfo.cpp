@@ -21,6 +21,7 @@
 #include <pvxs/sharedpv.h>
 #include <pvxs/source.h>
 #include <pvxs/nt.h>
+#include "serverconn.h"
 
 namespace {
 using namespace pvxs;
@@ -241,11 +242,196 @@ void testError()
     }
 }
 
+void testSearchIndex()
+{
+    testShow()<<__func__;
+
+    impl::SearchIndex idx;
+
+    testOk1(!idx.contains("foo"));
+    idx.add("foo");
+    idx.add("foo");
+    testOk1(idx.contains("foo"));
+    testEq(idx.size(), 1u);
+    idx.remove("foo");
+    testOk1(idx.contains("foo"));
+    idx.remove("foo");
+    testOk1(!idx.contains("foo"));
+    testEq(idx.size(), 0u);
+
+    // enough to grow the bloom filter a few times
+    constexpr size_t N = 20000u;
+    for(auto i : range(N)) {
+        idx.add(SB()<<"rec"<<i);
+    }
+    testEq(idx.size(), N);
+
+    size_t nfound = 0u, nfalse = 0u;
+    for(auto i : range(N)) {
+        if(idx.contains(std::string(SB()<<"rec"<<i).c_str()))
+            nfound++;
+        if(idx.contains(std::string(SB()<<"other"<<i).c_str()))
+            nfalse++;
+    }
+    testEq(nfound, N);
+    testEq(nfalse, 0u);
+
+    for(auto i : range(N)) {
+        idx.remove(SB()<<"rec"<<i);
+    }
+    testEq(idx.size(), 0u);
+    testOk1(!idx.contains("rec0"));
+}
+
+void testNegativeCache()
+{
+    testShow()<<__func__;
+
+    impl::NegativeSearchCache cache;
+    epicsTimeStamp t0{1000u, 0u}, t1{1001u, 0u}, t2{1003u, 0u};
+
+    testOk1(!cache.contains("foo", t0, 2.0));
+    cache.insert("foo", t0, 2.0);
+    testOk1(cache.contains("foo", t0, 2.0));
+    testOk1(cache.contains("foo", t1, 2.0));
+    testOk1(!cache.contains("foo", t2, 2.0));
+    testOk1(!cache.contains("bar", t1, 2.0));
+
+    // refresh
+    cache.insert("foo", t1, 2.0);
+    testOk1(cache.contains("foo", t2, 2.5));
+    testEq(cache.size(), 1u);
+}
+
+void testRateLimit()
+{
+    testShow()<<__func__;
+
+    impl::SearchRateLimit limit;
+    SockAddr peer1("127.0.0.1:1234"), peer1b("127.0.0.1:5678"), peer2("127.0.0.2:1234");
+    epicsTimeStamp t0{1000u, 0u}, t1{1000u, 500000000u};
+
+    testOk1(limit.allow(peer1, t0, 2.0, 2.0));
+    testOk1(limit.allow(peer1, t0, 2.0, 2.0));
+    testOk(!limit.allow(peer1b, t0, 2.0, 2.0), "limit by address, not port");
+    testOk1(limit.allow(peer2, t0, 2.0, 2.0));
+    // half a second refills one token
+    testOk1(limit.allow(peer1, t1, 2.0, 2.0));
+    testOk1(!limit.allow(peer1, t1, 2.0, 2.0));
+    testEq(limit.size(), 2u);
+}
+
+// claims nothing, and counts the times each name is searched for
+struct CountingSource : public server::Source
+{
+    epicsMutex lock;
+    std::map<std::string, size_t> counts;
+
+    virtual void onSearch(Search &op) override final
+    {
+        epicsGuard<epicsMutex> G(lock);
+        for(auto& name : op) {
+            counts[name.name()]++;
+        }
+    }
+    virtual void onCreate(std::unique_ptr<server::ChannelControl> &&op) override final {}
+
+    size_t count(const std::string& name)
+    {
+        epicsGuard<epicsMutex> G(lock);
+        return counts[name];
+    }
+};
+
+bool testFind(client::Context& cli, const char* name, double timeout);
+
+void testSearchCache()
+{
+    testShow()<<__func__;
+
+    auto counter(std::make_shared<CountingSource>());
+
+    auto conf(server::Config::isolated());
+    conf.searchCacheTimeout = 60.0;
+    auto serv = conf.build()
+            .addSource("count", counter)
+            .start();
+
+    auto cli = serv.clientConfig().build();
+
+    testOk(!testFind(cli, "nope", 2.1), "Do not find nope");
+    testEq(counter->count("nope"), 1u)<<" Sources asked about nope once";
+
+    // adding a name to a StaticSource forgets cached names
+    auto pv(server::SharedPV::buildReadonly());
+    pv.open(nt::NTScalar{TypeCode::Int32}.create());
+    auto src(server::StaticSource::build());
+    serv.addSource("extra", src.source(), 10);
+    src.add("nope", pv);
+
+    cli.cacheClear();
+    testOk(testFind(cli, "nope", 5.0), "Find nope after StaticSource::add()");
+    testEq(counter->count("nope"), 2u)<<" Sources asked about nope again";
+}
+
+bool testFind(client::Context& cli, const char* name, double timeout)
+{
+    epicsEvent done;
+
+    auto op = cli.info(name)
+            .result([&done](client::Result&& result) {
+                done.signal();
+            })
+            .exec();
+
+    cli.hurryUp();
+
+    return done.wait(timeout);
+}
+
+void testIndexedSource()
+{
+    testShow()<<__func__;
+
+    // StaticSource::remove() will close()
+    auto pv1(server::SharedPV::buildReadonly());
+    auto pv2(server::SharedPV::buildReadonly());
+    pv1.open(nt::NTScalar{TypeCode::Int32}.create());
+    pv2.open(nt::NTScalar{TypeCode::Int32}.create());
+
+    auto src(server::StaticSource::build());
+    src.add("early", pv1);
+
+    auto serv = server::Config::isolated()
+            .build()
+            .addSource("extra", src.source(), 10)
+            .start();
+
+    auto cli = serv.clientConfig().build();
+
+    testOk(testFind(cli, "early", 5.0), "Find name added before addSource()");
+
+    src.add("late", pv2);
+    testOk(testFind(cli, "late", 5.0), "Find name added after addSource()");
+
+    src.remove("late");
+    cli.cacheClear();
+    testOk(!testFind(cli, "late", 1.1), "Do not find removed name");
+
+    serv.removeSource("extra", 10);
+    cli.cacheClear();
+    testOk(!testFind(cli, "early", 1.1), "Do not find name of removed Source");
+
+    serv.addSource("extra", src.source(), 10);
+    cli.cacheClear();
+    testOk(testFind(cli, "early", 5.0), "Find name of re-added Source");
+}
+
 } // namespace
 
 MAIN(testinfo)
 {
-    testPlan(13);
+    testPlan(47);
     testSetup();
     logger_config_env();
     Tester().loopback();
@@ -255,5 +441,10 @@ MAIN(testinfo)
     Tester().asyncCancel();
     Tester().orphan();
     testError();
+    testSearchIndex();
+    testIndexedSource();
+    testNegativeCache();
+    testRateLimit();
+    testSearchCache();
     return testDone();
 }
@@ -21,6 +21,7 @@
 #include <pvxs/sharedpv.h>
 #include <pvxs/source.h>
 #include <pvxs/nt.h>
+#include "serverconn.h"
 
 namespace {
 using namespace pvxs;
@@ -292,6 +293,77 @@ struct TestLifeCycle : public BasicTest
             testFail("Missing data update");
         }
     }
+
+    // each update waits for the last to be delivered, so the subscriber
+    // repeatedly drains the ring and must wait again.
+    void testSequential()
+    {
+        testShow()<<__func__;
+
+        if(auto val = pop(sub, evt)) {
+            testEq(val["value"].as<int32_t>(), 42);
+        } else {
+            testFail("Missing data update");
+        }
+
+        for(auto i : range(5)) {
+            post(i);
+
+            if(auto val = pop(sub, evt)) {
+                testEq(val["value"].as<int32_t>(), i);
+            } else {
+                testFail("Missing data update %d", i);
+            }
+        }
+    }
+
+    void testDeltasOnly()
+    {
+        testShow()<<__func__;
+
+        epicsEvent evt2;
+        auto sub2 = cli.monitor("mailbox")
+                        .deltas()
+                        .maskConnected(true)
+                        .maskDisconnected(false)
+                        .event([&evt2](client::Subscription& sub) {
+                            testDiag("Event evt2");
+                            evt2.signal();
+                        })
+                        .exec();
+
+        if(auto val = pop(sub2, evt2)) {
+            testEq(val["value"].as<int32_t>(), 42);
+            testTrue(val["value"].isMarked(false));
+        } else {
+            testFail("Missing data update");
+        }
+
+        // leave .value at 42
+        {
+            auto update(initial.cloneEmpty());
+            update["alarm.severity"] = 1;
+            mbox.post(update);
+        }
+
+        if(auto val = pop(sub2, evt2)) {
+            testEq(val["value"].as<int32_t>(), 0)<<" not filled in";
+            testEq(val["alarm.severity"].as<uint32_t>(), 1u);
+            testFalse(val["value"].isMarked(false));
+            testTrue(val["alarm.severity"].isMarked(false));
+        } else {
+            testFail("Missing data update");
+        }
+
+        // unaffected
+        (void)pop(sub, evt);
+        if(auto val = pop(sub, evt)) {
+            testEq(val["value"].as<int32_t>(), 42);
+            testEq(val["alarm.severity"].as<uint32_t>(), 1u);
+        } else {
+            testFail("Missing data update");
+        }
+    }
 };
 
 struct TestReconn : public BasicTest
@@ -359,14 +431,213 @@ struct TestReconn : public BasicTest
     }
 };
 
+// updates large enough to be sent as several segments
+void testLargeArray(bool srvBE)
+{
+    testShow()<<__func__<<" srvBE="<<srvBE;
+
+    auto makeArr = [](double offset) -> shared_array<const double> {
+        shared_array<double> arr(400000u); // 3.2 MB
+        for(size_t i=0u; i<arr.size(); i++)
+            arr[i] = offset + double(i);
+        return arr.freeze();
+    };
+
+    auto initial(nt::NTScalar{TypeCode::Float64A}.create());
+    initial["value"] = makeArr(0.0);
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    auto serv = server::Config::isolated()
+            .overrideSendBE(srvBE)
+            .build()
+            .addPV("mailbox", mbox)
+            .start();
+    auto cli = serv.clientConfig().build();
+
+    epicsEvent evt;
+    auto sub(cli.monitor("mailbox")
+             .maskConnected(true)
+             .maskDisconnected(true)
+             .event([&evt](client::Subscription&) {
+                 evt.signal();
+             })
+             .exec());
+
+    for(double offset : {0.0, 0.5}) {
+        auto expect(makeArr(offset));
+        if(offset!=0.0) {
+            auto update(initial.cloneEmpty());
+            update["value"] = expect;
+            update["alarm.severity"] = 1;
+            mbox.post(update);
+        }
+
+        auto val(BasicTest::pop(sub, evt));
+        auto actual(val["value"].as<shared_array<const double>>());
+        testTrue(actual.size()==expect.size() && std::equal(expect.begin(), expect.end(), actual.begin()))
+                <<" size "<<actual.size();
+        testEq(val["alarm.severity"].as<int32_t>(), offset!=0.0 ? 1 : 0);
+    }
+}
+
+struct RingWaiter : public impl::UpdateRing::Reader {
+    size_t nwake = 0u;
+    virtual void wakeup() override final { nwake++; }
+};
+
+void testUpdateRing()
+{
+    testShow()<<__func__;
+
+    auto r1(std::make_shared<RingWaiter>());
+    auto r2(std::make_shared<RingWaiter>());
+
+    auto prototype(nt::NTScalar{TypeCode::Int32}.create());
+    impl::UpdateRing ring;
+    size_t nsquash = 0u;
+    const uint64_t end = uint64_t(-1);
+
+    ring.attach(r1, 2u);
+    testEq(ring.depth(), 2u);
+    testFalse(ring.pop(r1.get(), end, nsquash));
+    testTrue(ring.waitFor(r1.get()));
+
+    for(auto i : range(6)) {
+        auto update(prototype.cloneEmpty());
+        update["value"] = i;
+        if(i==1)
+            update["alarm.severity"] = 1;
+        auto snap(ring.push(update));
+        testTrue(Value::Helper::store_ptr(snap)!=Value::Helper::store_ptr(update));
+    }
+    testEq(r1->nwake, 1u)<<" only woken once";
+    testFalse(ring.waitFor(r1.get()));
+    testEq(ring.pending(r1.get(), end), 2u);
+    testEq(ring.size(), 2u);
+
+    // reader has fallen behind by more than its limit, and past the retained entries
+    if(auto val = ring.pop(r1.get(), end, nsquash)) {
+        testEq(val["value"].as<int32_t>(), 4);
+        testTrue(val["alarm.severity"].isMarked())<<" change from dropped entry retained";
+        testEq(val["alarm.severity"].as<int32_t>(), 1);
+    } else {
+        testFail("Missing update");
+    }
+    testEq(nsquash, 4u);
+
+    testEq(ring.pop(r1.get(), end, nsquash)["value"].as<int32_t>(), 5);
+    testFalse(ring.pop(r1.get(), end, nsquash));
+    testEq(nsquash, 4u);
+    testEq(ring.size(), 0u)<<" entries read by all readers are released";
+
+    ring.attach(r2, 4u);
+    testEq(ring.depth(), 4u);
+
+    for(auto i : range(6, 8)) {
+        auto update(prototype.cloneEmpty());
+        update["value"] = i;
+        ring.push(update);
+    }
+
+    // un-merged entries are shared between readers
+    auto a(ring.pop(r1.get(), end, nsquash));
+    auto b(ring.pop(r2.get(), end, nsquash));
+    testEq(a["value"].as<int32_t>(), 6);
+    testTrue(Value::Helper::store_ptr(a)==Value::Helper::store_ptr(b));
+
+    // entries before the end are not read
+    testEq(ring.pending(r2.get(), 7u), 0u);
+    testEq(ring.pending(r2.get(), 8u), 1u);
+    testFalse(ring.pop(r2.get(), 7u, nsquash));
+
+    // entries are retained until the last reader passes
+    testEq(ring.size(), 1u);
+    testEq(ring.pop(r1.get(), end, nsquash)["value"].as<int32_t>(), 7);
+    testEq(ring.size(), 1u);
+    testEq(ring.pop(r2.get(), end, nsquash)["value"].as<int32_t>(), 7);
+    testEq(ring.size(), 0u);
+
+    // depth follows the readers which remain
+    ring.detach(r2.get());
+    testEq(ring.depth(), 2u);
+
+    for(auto i : range(8, 11)) {
+        auto update(prototype.cloneEmpty());
+        update["value"] = i;
+        ring.push(update);
+    }
+    testEq(ring.size(), 2u);
+    ring.detach(r1.get());
+    testEq(ring.size(), 0u)<<" entries released when the last reader detaches";
+    testEq(ring.depth(), 1u);
+
+    ring.push(prototype.cloneEmpty());
+    testEq(ring.size(), 0u)<<" nothing retained without readers";
+}
+
+void testUpdateRingGrow()
+{
+    testShow()<<__func__;
+
+    auto r1(std::make_shared<RingWaiter>());
+    auto r2(std::make_shared<RingWaiter>());
+
+    auto prototype(nt::NTScalar{TypeCode::Int32}.create());
+    impl::UpdateRing ring;
+    size_t nsquash = 0u;
+    const uint64_t end = uint64_t(-1);
+
+    ring.attach(r1, 4u);
+
+    for(auto i : range(10)) {
+        auto update(prototype.cloneEmpty());
+        update["value"] = i;
+        if(i==4)
+            update["alarm.severity"] = 1;
+        ring.push(update);
+    }
+
+    // #6 through #9 retained.  Growing must not expose empty slots as retained.
+    ring.attach(r2, 8u);
+    testEq(ring.depth(), 8u);
+    testEq(ring.size(), 4u);
+
+    // r1 is older than the oldest entry retained
+    if(auto val = ring.pop(r1.get(), end, nsquash)) {
+        testEq(val["value"].as<int32_t>(), 6);
+        testTrue(val["alarm.severity"].isMarked())<<" change from dropped entry retained";
+        testEq(val["alarm.severity"].as<int32_t>(), 1);
+    } else {
+        testFail("Missing update");
+    }
+    testEq(nsquash, 6u);
+    testEq(ring.pop(r1.get(), end, nsquash)["value"].as<int32_t>(), 7);
+
+    // entries pushed after growth are retained alongside the old
+    for(auto i : range(10, 14)) {
+        auto update(prototype.cloneEmpty());
+        update["value"] = i;
+        ring.push(update);
+    }
+    testEq(ring.size(), 6u);
+    testEq(ring.pending(r1.get(), end), 4u);
+    testEq(ring.pop(r1.get(), end, nsquash)["value"].as<int32_t>(), 10);
+    testEq(nsquash, 8u);
+    testEq(ring.pending(r2.get(), end), 4u);
+    testEq(ring.pop(r2.get(), end, nsquash)["value"].as<int32_t>(), 10);
+}
+
 } // namespace
 
 MAIN(testmon)
 {
-    testPlan(41);
+    testPlan(115);
     testSetup();
     try{
         logger_config_env();
+        testUpdateRing();
+        testUpdateRingGrow();
         BasicTest().orphan();
         BasicTest().cancel();
         BasicTest().asyncCancel();
@@ -375,8 +646,12 @@ MAIN(testmon)
         TestLifeCycle().testBasic(false);
         TestLifeCycle().testSecond();
         TestLifeCycle().testDelta();
+        TestLifeCycle().testDeltasOnly();
+        TestLifeCycle().testSequential();
         TestReconn().testReconn(false);
         TestReconn().testReconn(true);
+        testLargeArray(false);
+        testLargeArray(true);
     }catch(std::exception& e) {
         testFail("Unhandled exception %s : %s", typeid(e).name(), e.what());
         throw;
@@ -10,6 +10,7 @@
 
 #include <pvxs/unittest.h>
 #include <pvxs/nt.h>
+#include "utilpvt.h"
 
 namespace {
 
@@ -97,14 +98,85 @@ void testNTTable()
     testTrue(top["value.B"].type()==TypeCode::StringA);
 }
 
+void testTableBuilder()
+{
+    testDiag("In %s", __func__);
+
+    auto prototype = nt::NTTable{}
+            .add_column(TypeCode::Int32, "A", "Col A")
+            .add_column(TypeCode::String, "B", "Col B")
+            .add_column(TypeCode::Float64, "C")
+            .create();
+
+    nt::TableBuilder builder(prototype);
+    auto A(builder.column<int32_t>("A"));
+    auto B(builder.column<std::string>("B"));
+    // C not set
+
+    testThrows<LookupError>([&builder]() {
+        builder.column<int32_t>("nonexistent");
+    });
+    testThrows<NoConvert>([&builder]() {
+        builder.column<double>("A");
+    });
+
+    const size_t nrows = 100u; // several re-allocations
+    for(size_t i=0u; i<nrows; i++) {
+        auto row(builder.append());
+        A[row] = int32_t(i);
+        B[row] = SB()<<"row"<<i;
+    }
+    testEq(builder.size(), nrows);
+
+    auto table(builder.build());
+    testEq(builder.size(), 0u);
+    testArrEq(table["labels"].as<shared_array<const std::string>>(),
+              shared_array<const std::string>({"Col A", "Col B", "C"}));
+    testTrue(table["value.A"].isMarked());
+    testTrue(table["value.C"].isMarked());
+
+    nt::TableReader reader(table);
+    testEq(reader.size(), nrows);
+
+    auto colA(reader.column<int32_t>("A"));
+    testEq(colA.size(), nrows);
+    testTrue(colA.data()==table["value.A"].as<shared_array<const int32_t>>().data())<<" not copied";
+    testEq(reader.column<double>("A")[5], 5.0)<<" converted";
+    testEq(reader.column<double>("C")[5], 0.0);
+
+    size_t i = 0u, nok = 0u;
+    for(auto row : reader.rows<int32_t, std::string>("A", "B")) {
+        if(size_t(std::get<0>(row))==i && std::get<1>(row)==std::string(SB()<<"row"<<i))
+            nok++;
+        i++;
+    }
+    testEq(nok, nrows);
+
+    testThrows<LookupError>([&reader]() {
+        reader.column<int32_t>("nonexistent");
+    });
+
+    // builder may be re-used
+    builder.reserve(3u);
+    for(int32_t i=0; i<3; i++)
+        A[builder.append()] = 10+i;
+    auto table2(builder.build());
+    testArrEq(table2["value.A"].as<shared_array<const int32_t>>(), shared_array<const int32_t>({10, 11, 12}));
+    testArrEq(table2["value.B"].as<shared_array<const std::string>>(), shared_array<const std::string>({"", "", ""}));
+    testEq(nt::TableReader(table2).size(), 3u);
+    // earlier result unchanged
+    testEq(table["value.A"].as<shared_array<const int32_t>>()[0], 0);
+}
+
 } // namespace
 
 MAIN(testnt) {
-    testPlan(21);
+    testPlan(39);
     testNTScalar();
     testNTNDArray();
     testNTURI();
     testNTEnum();
     testNTTable();
+    testTableBuilder();
     return testDone();
 }
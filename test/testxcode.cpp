@@ -14,6 +14,7 @@
 #include <pvxs/nt.h>
 #include "dataimpl.h"
 #include "pvaproto.h"
+#include "evhelper.h"
 
 namespace {
 using namespace pvxs;
@@ -80,6 +81,53 @@ void testDeserializeString()
         });
         testEq(dut, "hello world");
     }
+
+    {
+        std::string dut("a string too long for SSO");
+        auto storage = dut.data();
+        testFromBytes(true, "\x19" "a string too long for SSO", [&dut](Buffer& buf) {
+            from_wire(buf, dut);
+        });
+        testEq(dut, "a string too long for SSO");
+        testTrue(dut.data()==storage)<<" unchanged value not re-assigned";
+    }
+}
+
+void testInternStringArray()
+{
+    testDiag("%s", __func__);
+
+    auto prototype(nt::NTEnum{}.create());
+
+    auto encode = [&prototype](std::initializer_list<std::string> choices) -> std::vector<uint8_t> {
+        auto val(prototype.cloneEmpty());
+        val["value.choices"] = shared_array<const std::string>(choices);
+        std::vector<uint8_t> ret;
+        VectorOutBuf buf(true, ret);
+        to_wire_full(buf, val);
+        ret.resize(ret.size()-buf.size());
+        return ret;
+    };
+    auto decode = [&prototype](std::vector<uint8_t>& bytes) -> shared_array<const std::string> {
+        auto val(prototype.cloneEmpty());
+        TypeStore ctxt;
+        FixedBuf buf(true, bytes);
+        from_wire_full(buf, ctxt, val);
+        testOk(buf.good() && buf.empty(), "Deserialize NTEnum");
+        return val["value.choices"].as<shared_array<const std::string>>();
+    };
+
+    auto bytes1(encode({"zero", "one", "a choice too long for SSO"}));
+    auto bytes2(encode({"zero", "one", "another choice too long for SSO"}));
+
+    auto A(decode(bytes1));
+    auto B(decode(bytes1));
+    auto C(decode(bytes2));
+
+    testArrEq(A, shared_array<const std::string>({"zero", "one", "a choice too long for SSO"}));
+    testTrue(A.data()==B.data())<<" repeated choices share storage";
+    testArrEq(C, shared_array<const std::string>({"zero", "one", "another choice too long for SSO"}));
+    testTrue(A.data()!=C.data());
 }
 
 void testSerialize1()
@@ -602,6 +650,171 @@ void testArrayXCode()
     testArrayXCodeT<std::string>("\x01\x02\x02\x05hello\x05world", {"hello", "world"});
 }
 
+void testByteSwap()
+{
+    testDiag("%s", __func__);
+
+    std::vector<uint8_t> input(8u*67u + 1u);
+    for(auto i : range(input.size()))
+        input[i] = uint8_t(i*7u + 3u);
+
+    for(auto kern : {SwapKernel::Scalar, SwapKernel::SSE2, SwapKernel::AVX2, SwapKernel::NEON}) {
+        for(size_t width : {2u, 4u, 8u}) {
+            std::vector<uint8_t> dummy(16u);
+            if(!copySwappedWith(kern, dummy.data(), input.data(), 1u, width)) {
+                testSkip(1, swapKernelName(kern));
+                continue;
+            }
+
+            size_t nbad = 0u;
+            // all counts around vector sizes, unaligned
+            for(size_t count=0u; count<=67u; count++) {
+                std::vector<uint8_t> actual(count*width + 1u);
+                copySwappedWith(kern, actual.data()+1u, input.data()+1u, count, width);
+
+                for(auto i : range(count*width)) {
+                    auto elem = i/width, byte = i%width;
+                    if(actual[1u + i] != input[1u + elem*width + width-1u - byte])
+                        nbad++;
+                }
+            }
+            testEq(nbad, 0u)<<swapKernelName(kern)<<" width="<<width;
+        }
+    }
+    testDiag("Selected %s", swapKernelName(swapKernelSelected()));
+}
+
+template<typename E>
+void testArrayXCodeLarge(bool be)
+{
+    testDiag("%s<%s>(%s)", __func__, TypeCode(ScalarMap<E>::code).name(), be ? "BE" : "LE");
+
+    shared_array<E> temp(1021u);
+    for(auto i : range(temp.size()))
+        temp[i] = E(i*3u + 1u);
+    auto expected(temp.freeze().template castTo<const void>());
+
+    std::vector<uint8_t> bytes;
+    {
+        VectorOutBuf buf(be, bytes);
+        to_wire<E>(buf, expected);
+        testOk1(buf.good());
+        bytes.resize(bytes.size()-buf.size());
+    }
+
+    shared_array<const void> actual;
+    {
+        FixedBuf buf(be, bytes);
+        from_wire<E>(buf, actual);
+        testTrue(buf.good() && buf.empty());
+    }
+
+    auto iexpected(expected.template castTo<const E>());
+    auto iactual(actual.template castTo<const E>());
+    testTrue(iactual.size()==iexpected.size() && std::equal(iexpected.begin(), iexpected.end(), iactual.begin()));
+}
+
+// large arrays in native byte order are appended to an evbuffer by reference
+void testArrayReference(bool be)
+{
+    testDiag("%s(%s)", __func__, be==hostBE ? "native" : "swap");
+
+    shared_array<uint32_t> temp(100000u);
+    for(auto i : range(temp.size()))
+        temp[i] = uint32_t(i);
+    const auto arr(temp.freeze());
+
+    evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+    {
+        EvOutBuf buf(be, ebuf.get());
+        to_wire(buf, uint8_t(0x42));
+        to_wire<uint32_t>(buf, arr.castTo<const void>());
+        to_wire(buf, uint8_t(0x43));
+        testOk1(buf.good());
+    }
+    testEq(evbuffer_get_length(ebuf.get()), 1u + 5u + 4u*arr.size() + 1u);
+    testEq(!arr.unique(), be==hostBE)<<" array referenced";
+
+    {
+        uint8_t before=0, after=0;
+        shared_array<const void> actual;
+        EvInBuf buf(be, ebuf.get());
+        from_wire(buf, before);
+        from_wire<uint32_t>(buf, actual);
+        from_wire(buf, after);
+        testOk1(buf.good());
+        testEq(before, 0x42);
+        testEq(after, 0x43);
+        auto iactual(actual.castTo<const uint32_t>());
+        testTrue(iactual.size()==arr.size() && std::equal(arr.begin(), arr.end(), iactual.begin()));
+    }
+    testEq(evbuffer_get_length(ebuf.get()), 0u);
+    testTrue(arr.unique())<<" reference released";
+}
+
+// array length exceeds remaining message
+void testArrayTruncated()
+{
+    testDiag("%s", __func__);
+
+    evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+    {
+        EvOutBuf buf(true, ebuf.get());
+        to_wire(buf, Size{100000u});
+        for(auto i : range(10u))
+            to_wire(buf, uint32_t(i));
+        testOk1(buf.good());
+    }
+
+    shared_array<const void> actual;
+    EvInBuf buf(true, ebuf.get());
+    from_wire<uint32_t>(buf, actual);
+    testFalse(buf.good());
+}
+
+template<size_t N>
+void testSegmentTx(std::initializer_list<const char*> chains, size_t maxSegment, const char(&expect)[N])
+{
+    evbuf body(__FILE__, __LINE__, evbuffer_new());
+    for(auto chain : chains) // a separate chain for each
+        evbuffer_add_reference(body.get(), chain, strlen(chain), nullptr, nullptr);
+
+    evbuf tx(__FILE__, __LINE__, evbuffer_new());
+    auto ntx = to_evbuf(tx.get(), Header{CMD_MONITOR, pva_flags::Server, 0u}, body.get(), true, maxSegment);
+
+    std::vector<uint8_t> actual(evbuffer_get_length(tx.get()));
+    evbuffer_copyout(tx.get(), actual.data(), actual.size());
+
+    testEq(ntx, actual.size());
+    testEq(evbuffer_get_length(body.get()), 0u);
+    testBytes(actual, expect);
+}
+
+void testSegmentTx()
+{
+    testDiag("%s", __func__);
+
+    // short enough
+    testSegmentTx({"abcd", "efgh"}, 8u,
+                  "\xca\x02\xc0\x0d\x00\x00\x00\x08""abcdefgh");
+    // one chain per segment
+    testSegmentTx({"abcd", "efgh", "ijkl"}, 6u,
+                  "\xca\x02\xd0\x0d\x00\x00\x00\x04""abcd"
+                  "\xca\x02\xf0\x0d\x00\x00\x00\x04""efgh"
+                  "\xca\x02\xe0\x0d\x00\x00\x00\x04""ijkl");
+    // chains combined
+    testSegmentTx({"abc", "def", "ghi", "jk"}, 6u,
+                  "\xca\x02\xd0\x0d\x00\x00\x00\x06""abcdef"
+                  "\xca\x02\xe0\x0d\x00\x00\x00\x05""ghijk");
+    // long chain not split
+    testSegmentTx({"abcdefghij"}, 4u,
+                  "\xca\x02\xc0\x0d\x00\x00\x00\x0a""abcdefghij");
+    testSegmentTx({"ab", "cdefghij", "k"}, 4u,
+                  "\xca\x02\xd0\x0d\x00\x00\x00\x02""ab"
+                  "\xca\x02\xf0\x0d\x00\x00\x00\x08""cdefghij"
+                  "\xca\x02\xe0\x0d\x00\x00\x00\x01""k");
+}
+
 /*  epics:nt/NTScalarArray:1.0
  *      double[] value
  *      alarm_t alarm
@@ -1077,6 +1290,366 @@ void testRegressRedundantBitMask()
     }, reencoded_value);
 }
 
+BitMask maskOf(size_t nbits, bool all, const BitMask* orig=nullptr)
+{
+    BitMask ret(nbits);
+    for(auto i : range(nbits))
+        ret[i] = all || (orig && (*orig)[i]);
+    return ret;
+}
+
+// EncodePlan must produce the same bytes as to_wire_valid() with a mask
+void testEncodePlan()
+{
+    testDiag("%s", __func__);
+
+    using namespace pvxs::members;
+    auto val = TypeDef(TypeCode::Struct, {
+                           Int32("i"),
+                           Float64A("arr"),
+                           Any("any"),
+                           Struct("sub", {
+                               String("s"),
+                               Bool("b"),
+                               Struct("inner", {
+                                   UInt16("u"),
+                                   Float32("f"),
+                               }),
+                           }),
+                           Int8("last"),
+                       }).create();
+    val["i"] = -5;
+    val["arr"] = shared_array<const double>({1.0, 2.0});
+    val["any"] = uint64_t(42u);
+    val["sub.s"] = "hello";
+    val["sub.b"] = true;
+    val["sub.inner.u"] = 0x1234;
+    val["sub.inner.f"] = 1.5;
+    val["last"] = 7;
+
+    auto desc = Value::Helper::desc(val);
+    const auto N = desc->size();
+
+    std::vector<BitMask> masks;
+    masks.push_back(maskOf(N, true));
+    for(auto i : range(N)) {
+        masks.emplace_back(N);
+        masks.back()[i] = true;
+        if(i+1u < N) { // also a pair
+            masks.emplace_back(N);
+            masks.back()[i] = masks.back()[i+1u] = true;
+        }
+    }
+
+    size_t nbad = 0u, ncase = 0u;
+    for(auto& mask : masks) {
+        EncodePlan plan(Value::Helper::type(val), maskOf(N, false, &mask));
+
+        // none marked, each one field marked, and all marked
+        for(auto mark : range(N+2u)) {
+            val.unmark();
+            if(mark==N+1u)
+                val.mark();
+            else if(mark < N)
+                Value::Helper::store_ptr(val)[mark].setValid(true);
+
+            std::vector<uint8_t> expect, actual;
+            {
+                VectorOutBuf buf(true, expect);
+                to_wire_valid(buf, val, &mask);
+                expect.resize(expect.size()-buf.size());
+            }
+            {
+                VectorOutBuf buf(true, actual);
+                to_wire_valid(buf, val, plan);
+                actual.resize(actual.size()-buf.size());
+            }
+            ncase++;
+            if(expect!=actual) {
+                nbad++;
+                testDiag("Mismatch mask=%s mark=%u",
+                         std::string(SB()<<mask).c_str(), unsigned(mark));
+            }
+        }
+    }
+    testEq(nbad, 0u)<<" of "<<ncase;
+
+    // plan for a different type falls back to mask
+    {
+        auto other = nt::NTScalar{TypeCode::Int32}.create();
+        other["value"] = 3;
+        EncodePlan plan(Value::Helper::type(val), maskOf(N, true));
+        plan.mask = maskOf(Value::Helper::desc(other)->size(), true);
+
+        testToBytes(true, [&other, &plan](Buffer& buf) {
+            to_wire_valid(buf, other, plan);
+            testOk1(buf.good());
+        }, "\x01\x02\x00\x00\x00\x03");
+    }
+}
+
+// encode through an evbuffer, which may reference shared encodings
+std::vector<uint8_t> encodeVia(bool be, const Value& val, const EncodePlan& plan)
+{
+    evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+    {
+        EvOutBuf buf(be, ebuf.get());
+        to_wire_valid(buf, val, plan);
+        testOk1(buf.good());
+    }
+    std::vector<uint8_t> ret(evbuffer_get_length(ebuf.get()));
+    evbuffer_copyout(ebuf.get(), ret.data(), ret.size());
+    return ret;
+}
+
+void testSharedEncoding(size_t nelem)
+{
+    testDiag("%s(%zu)", __func__, nelem);
+
+    auto val(nt::NTScalar{TypeCode::Float64A}.create());
+    {
+        shared_array<double> arr(nelem);
+        for(auto i : range(arr.size()))
+            arr[i] = i;
+        val["value"] = arr.freeze();
+    }
+    val["alarm.severity"] = 1;
+
+    auto desc = Value::Helper::desc(val);
+    EncodePlan plan(Value::Helper::type(val), maskOf(desc->size(), true));
+
+    std::vector<uint8_t> expectLE, expectBE;
+    {
+        VectorOutBuf buf(false, expectLE);
+        to_wire_valid(buf, val, plan);
+        expectLE.resize(expectLE.size()-buf.size());
+    }
+
+    testThrows<std::logic_error>([&val]() {
+        shareEncoding(val["alarm"]);
+    });
+
+    testFalse(isEncodingShared(val));
+    shareEncoding(val);
+    testTrue(isEncodingShared(val));
+    testFalse(isEncodingShared(val.clone()));
+
+    testTrue(encodeVia(false, val, plan)==expectLE);
+    testTrue(encodeVia(false, val, plan)==expectLE);
+
+    // breaks the promise, but shows that the cached encoding is re-used
+    val["alarm.severity"] = 2;
+    testTrue(encodeVia(false, val, plan)==expectLE);
+
+    // different byte order is encoded separately
+    {
+        VectorOutBuf buf(true, expectBE);
+        to_wire_valid(buf, val.clone(), plan);
+        expectBE.resize(expectBE.size()-buf.size());
+    }
+    testTrue(encodeVia(true, val, plan)==expectBE);
+
+    // as is a different mask
+    auto mask(maskOf(desc->size(), false));
+    mask[0] = true;
+    EncodePlan plan2(Value::Helper::type(val), std::move(mask));
+    {
+        std::vector<uint8_t> expect;
+        {
+            VectorOutBuf buf(false, expect);
+            to_wire_valid(buf, val.clone(), plan2);
+            expect.resize(expect.size()-buf.size());
+        }
+        testTrue(encodeVia(false, val, plan2)==expect);
+    }
+}
+
+void testSnapshotPool()
+{
+    testDiag("%s", __func__);
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    auto desc = Value::Helper::desc(initial);
+    EncodePlan plan(Value::Helper::type(initial), maskOf(desc->size(), true));
+
+    SnapshotPool pool(2u);
+
+    auto update(initial.cloneEmpty());
+    update["value"] = 1;
+    update["alarm.severity"] = 2;
+
+    auto A(pool.snapshot(update));
+    auto Astore = Value::Helper::store_ptr(A);
+    testTrue(isEncodingShared(A));
+    testEq(A["value"].as<int32_t>(), 1);
+    testTrue(A["alarm.severity"].isMarked());
+    auto Abytes(encodeVia(false, A, plan));
+
+    update = initial.cloneEmpty();
+    update["value"] = 3;
+
+    // A still referenced, so a second copy
+    auto B(pool.snapshot(update));
+    testNotEq(Value::Helper::store_ptr(B), Astore);
+    testEq(B["value"].as<int32_t>(), 3);
+
+    // pool is full
+    auto C(pool.snapshot(update));
+    testNotEq(Value::Helper::store_ptr(C), Astore);
+    testNotEq(Value::Helper::store_ptr(C), Value::Helper::store_ptr(B));
+
+    A = Value();
+    update["value"] = 4;
+
+    auto D(pool.snapshot(update));
+    testEq(Value::Helper::store_ptr(D), Astore)<<" re-use A";
+    testEq(D["value"].as<int32_t>(), 4);
+    testFalse(D["alarm.severity"].isMarked())<<" only marked in update";
+    testTrue(isEncodingShared(D));
+    // cached encoding of A discarded
+    auto Dbytes(encodeVia(false, D, plan));
+    testTrue(Dbytes!=Abytes);
+    {
+        std::vector<uint8_t> expect;
+        {
+            VectorOutBuf buf(false, expect);
+            to_wire_valid(buf, update, plan);
+            expect.resize(expect.size()-buf.size());
+        }
+        testTrue(Dbytes==expect);
+    }
+
+    // only idle copies are released
+    std::weak_ptr<const impl::FieldStorage> Bstore(Value::Helper::store(B));
+    auto Dstore = Value::Helper::store_ptr(D);
+    B = C = Value();
+    testFalse(Bstore.expired())<<" B retained by pool";
+    pool.trim();
+    testTrue(Bstore.expired())<<" B released";
+    D = Value();
+    auto E(pool.snapshot(update));
+    testEq(Value::Helper::store_ptr(E), Dstore)<<" D retained";
+}
+
+void testSnapshotPoolArray()
+{
+    testDiag("%s", __func__);
+
+    auto initial(nt::NTScalar{TypeCode::Float64A}.create());
+
+    SnapshotPool pool(1u);
+
+    shared_array<const double> arr({1.0, 2.0, 3.0});
+
+    auto update(initial.cloneEmpty());
+    update["value"] = arr;
+    update["alarm.message"] = "hello";
+
+    auto A(pool.snapshot(update));
+    auto Astore = Value::Helper::store_ptr(A);
+    testEq(A["value"].as<shared_array<const double>>().size(), 3u);
+    A = Value();
+
+    update = initial.cloneEmpty();
+    update["alarm.severity"] = 1;
+    update["timeStamp"].mark();
+
+    auto B(pool.snapshot(update));
+    testEq(Value::Helper::store_ptr(B), Astore)<<" re-use A";
+    testFalse(B["value"].isMarked());
+    testTrue(B["value"].as<shared_array<const double>>().empty())<<" unmarked array released";
+    testEq(B["alarm.message"].as<std::string>(), "")<<" unmarked string cleared";
+    testTrue(B["timeStamp"].isMarked());
+    testEq(B["alarm.severity"].as<int32_t>(), 1);
+}
+
+// ValidDecoder fed in chunks must match from_wire_valid()
+void testValidDecoder(bool be, size_t chunk)
+{
+    testDiag("%s(%c, %zu)", __func__, be ? 'B' : 'L', chunk);
+
+    using namespace pvxs::members;
+    auto def = TypeDef(TypeCode::Struct, {
+                           Int32("i"),
+                           Float64A("arr"),
+                           String("s"),
+                           Struct("sub", {
+                               UInt16("u"),
+                               Float32A("fa"),
+                           }),
+                           Int8A("empty"),
+                           Bool("b"),
+                           StringA("sa"),
+                           Any("any"),
+                       });
+    auto val(def.create());
+    {
+        shared_array<double> arr(100u);
+        for(auto i : range(arr.size()))
+            arr[i] = i*1.5;
+        val["arr"] = arr.freeze();
+    }
+    val["i"] = -42;
+    val["s"] = "hello world";
+    val["sub.u"] = 0x1234;
+    val["sa"] = shared_array<const std::string>({"a", "bc"});
+    val["sub.fa"] = shared_array<const float>({1.0f, 2.0f, 3.0f});
+    val["empty"] = shared_array<const int8_t>();
+    val["b"] = true;
+    val["any"] = "anything";
+    val["sub.u"].unmark();
+    val["sub"].mark(); // entire sub-struct
+
+    std::vector<uint8_t> bytes;
+    {
+        VectorOutBuf buf(be, bytes);
+        to_wire_valid(buf, val);
+        bytes.resize(bytes.size()-buf.size());
+    }
+
+    // reference
+    auto expect(def.create());
+    {
+        TypeStore ctxt;
+        FixedBuf buf(be, bytes);
+        from_wire_valid(buf, ctxt, expect);
+    }
+
+    evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+    TypeStore ctxt;
+    ValidDecoder decoder(def.create());
+    size_t pos = 0u;
+    // all but the last byte in chunks
+    while(pos+1u < bytes.size()) {
+        auto n = std::min(chunk, bytes.size()-1u-pos);
+        evbuffer_add(ebuf.get(), bytes.data()+pos, n);
+        pos += n;
+        decoder.partial(ebuf.get(), be, ctxt);
+    }
+    // decoding stops at the StringA, the rest waits for finish()
+    testTrue(evbuffer_get_length(ebuf.get()) < 16u)<<" remaining "<<evbuffer_get_length(ebuf.get());
+    evbuffer_add(ebuf.get(), bytes.data()+pos, bytes.size()-pos);
+    {
+        EvInBuf buf(be, ebuf.get());
+        decoder.finish(buf, ctxt);
+        testOk1(buf.good());
+    }
+    testEq(evbuffer_get_length(ebuf.get()), 0u);
+
+    std::vector<uint8_t> expectBytes, actualBytes;
+    {
+        VectorOutBuf buf(be, expectBytes);
+        to_wire_valid(buf, expect);
+        expectBytes.resize(expectBytes.size()-buf.size());
+    }
+    {
+        VectorOutBuf buf(be, actualBytes);
+        to_wire_valid(buf, decoder.val);
+        actualBytes.resize(actualBytes.size()-buf.size());
+    }
+    testTrue(expectBytes==actualBytes)<<"\n"<<expect<<"\n"<<decoder.val;
+}
+
 // issue with TypeStore maintenance
 void testRegressCNEN()
 {
@@ -1219,9 +1792,10 @@ void testEmptyRequest()
 
 MAIN(testxcode)
 {
-    testPlan(143);
+    testPlan(306);
     testSetup();
     testDeserializeString();
+    testInternStringArray();
     testSerialize1();
     testDeserialize1();
     testSimpleDef();
@@ -1230,9 +1804,27 @@ MAIN(testxcode)
     testDeserialize3();
     testDecode1();
     testArrayXCode();
+    testByteSwap();
+    testArrayTruncated();
+    testSegmentTx();
+    for(auto be : {false, true}) {
+        testArrayXCodeLarge<uint16_t>(be);
+        testArrayXCodeLarge<float>(be);
+        testArrayXCodeLarge<int64_t>(be);
+        testArrayReference(be);
+    }
     testXCodeNTScalar();
     testXCodeNTNDArray();
     testRegressRedundantBitMask();
+    testEncodePlan();
+    testSharedEncoding(10u);
+    testSharedEncoding(100000u); // large enough to reference
+    testSnapshotPool();
+    testSnapshotPoolArray();
+    for(auto be : {false, true}) {
+        for(size_t chunk : {1u, 3u, 64u, 100000u})
+            testValidDecoder(be, chunk);
+    }
     testRegressCNEN();
     testRegressBadBitMask();
     testBadFieldName();
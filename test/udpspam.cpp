@@ -0,0 +1,192 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+/* Load generator for the UDP search receive path.
+ *
+ * Blast CMD_SEARCH datagrams at a local UDPManager onSearch() listener
+ * as fast as possible, then report how many were delivered, and how many
+ * the kernel dropped due to receive buffer overflow.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <atomic>
+
+#include <epicsTime.h>
+#include <epicsGetopt.h>
+#include <epicsThread.h>
+
+#include <pvxs/log.h>
+#include "evhelper.h"
+#include <udp_collector.h>
+
+#if EPICS_VERSION_INT < VERSION_INT(7,0,1,0)
+#define epicsMonotonicGet epicsTime::getCurrent
+#endif
+
+using namespace pvxs;
+
+namespace {
+
+template<typename T>
+bool parse_as(T& out, const char *s)
+{
+    std::istringstream strm(s);
+    return (strm>>out).fail() || !strm.eof();
+}
+
+int help(int ret, const char *argv0)
+{
+    std::cerr<<"Usage: "<<argv0<<" [-n <count>] [-N <#names>] [-d <usec>] [-r <rate>]\n"
+               "\n"
+               "  -n <count>   Number of search datagrams to send.  (default 100000)\n"
+               "  -N <#names>  Number of PV names in each search.  (default 1)\n"
+               "  -d <usec>    Simulated processing time per received search.  (default 0)\n"
+               "  -r <rate>    Limit send rate to this many datagrams per second.  (default unlimited)\n"
+            <<std::endl;
+    return ret;
+}
+
+std::vector<uint8_t> build_search(size_t nnames)
+{
+    std::vector<uint8_t> msg(1024, 0);
+    VectorOutBuf M(true, msg);
+
+    M.skip(8, __FILE__, __LINE__); // placeholder for header
+    to_wire(M, uint32_t(0x12345678));
+    M.skip(4, __FILE__, __LINE__);
+    SockAddr reply(SockAddr::any(AF_INET, 0x1020));
+    to_wire(M, reply);
+    to_wire(M, uint16_t(reply.port()));
+    to_wire(M, Size{1});
+    to_wire(M, "tcp");
+    to_wire(M, uint16_t(nnames));
+    for(auto i : range(nnames)) {
+        to_wire(M, uint32_t(i+1));
+        to_wire(M, SB()<<"spam:pv:"<<i);
+    }
+
+    auto pktlen = M.save()-msg.data();
+
+    FixedBuf H(true, msg.data(), 8);
+    to_wire(H, Header{CMD_SEARCH, 0, uint32_t(pktlen-8)});
+
+    if(!M.good() || !H.good())
+        throw std::logic_error("Unable to encode search");
+
+    msg.resize(pktlen);
+    return msg;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    SockAttach attach;
+    logger_config_env();
+
+    size_t count = 100000u;
+    size_t nnames = 1u;
+    unsigned delay = 0u;
+    double rate = 0.0;
+
+    {
+        int opt;
+        while((opt = getopt(argc, argv, "hn:N:d:r:")) != -1) {
+            switch (opt) {
+            case 'h':
+                return help(0, argv[0]);
+            default:
+                std::cerr<<"Unknown argument -"<<char(opt)<<std::endl;
+                return help(1, argv[0]);
+            case 'n':
+                if(parse_as(count, optarg)) {
+                    std::cerr<<"Invalid count: "<<optarg<<std::endl;
+                    return 1;
+                }
+                break;
+            case 'N':
+                if(parse_as(nnames, optarg) || nnames==0u || nnames>32u) {
+                    std::cerr<<"Invalid #names: "<<optarg<<std::endl;
+                    return 1;
+                }
+                break;
+            case 'd':
+                if(parse_as(delay, optarg)) {
+                    std::cerr<<"Invalid delay: "<<optarg<<std::endl;
+                    return 1;
+                }
+                break;
+            case 'r':
+                if(parse_as(rate, optarg) || rate<0.0) {
+                    std::cerr<<"Invalid rate: "<<optarg<<std::endl;
+                    return 1;
+                }
+                break;
+            }
+        }
+    }
+
+    SockAddr listener(SockAddr::loopback(AF_INET));
+
+    evsocket sock(AF_INET, SOCK_DGRAM, 0);
+    sock.bind(SockAddr::loopback(AF_INET));
+
+    std::atomic<size_t> nrx{0u};
+
+    auto manager = UDPManager::instance();
+    auto sub = manager.onSearch(listener, [&nrx, delay](const UDPManager::Search& msg)
+    {
+        nrx++;
+        if(delay)
+            epicsThreadSleep(delay*1e-6);
+    });
+    sub->start();
+    manager.sync();
+
+    auto msg(build_search(nnames));
+
+    std::cout<<"Sending "<<count<<" x "<<msg.size()<<" bytes to "<<listener<<std::endl;
+
+    size_t nsent = 0u;
+    auto t0(epicsMonotonicGet());
+
+    for(size_t i=0u; i<count; i++) {
+        auto ret = sendto(sock.sock, (char*)msg.data(), msg.size(), 0, &listener->sa, listener.size());
+        if(ret==int(msg.size()))
+            nsent++;
+
+        // when rate limited, send in bursts of 64 and sleep off any time remaining
+        if(rate>0.0 && i%64u==63u) {
+            double ahead = (i+1u)/rate - (epicsMonotonicGet()-t0)*1e-9;
+            if(ahead>0.0)
+                epicsThreadSleep(ahead);
+        }
+    }
+
+    auto t1(epicsMonotonicGet());
+
+    // wait for the receiver to go idle
+    for(size_t prev = size_t(-1); prev!=nrx.load(); ) {
+        prev = nrx.load();
+        epicsThreadSleep(0.1);
+    }
+    manager.sync();
+
+    auto t2(epicsMonotonicGet());
+
+    size_t nrecv = nrx.load();
+    double tsend = (t1-t0)*1e-9, tall = (t2-t0)*1e-9;
+
+    std::cout<<"Sent     "<<nsent<<" in "<<tsend<<" sec. ("<<nsent/tsend<<" /sec)\n"
+               "Received "<<nrecv<<" in "<<tall<<" sec.\n"
+               "Dropped  "<<(nsent-nrecv)<<" ("<<(nsent ? 100.0*(nsent-nrecv)/nsent : 0.0)<<" %)"
+            <<std::endl;
+
+    sub.reset();
+    return 0;
+}